@@ -0,0 +1,1588 @@
+// Headless benchmarks for the search core. Links against the core library only, no SFML.
+//
+// Usage:
+//   Benchmark throughput [rows cols queries solver seed threads]
+//       Answers `queries` random start/goal pairs on one shared maze with 1, 2, 4, ... up to
+//       `threads` (default: hardware threads) workers, each with its own SearchContext,
+//       and reports queries/sec and scaling.
+//   Benchmark openlist [rows cols queries seed]
+//       Runs Dijkstra, A* and JPS with each open-list policy from OpenList.h on an open
+//       map and a maze, and reports time, pushes/pops and the total path cost.
+//   Benchmark jps [rows cols queries seed]
+//       Compares jps against the bit-parallel jpsBits and the table-driven jpsPlus on an
+//       open map and a maze, including each variant's preprocessing time and memory.
+//   Benchmark costs [rows cols queries seed maxWeight]
+//       Dijkstra and A* with every cost model from CostModel.h (uniform, random terrain
+//       weights 1..maxWeight, octile with and without corner cutting, octile + terrain)
+//       and jps, on one random:20 map: time, nodes and mean path cost in unit steps.
+//   Benchmark engine [rows cols queries seed repeat]
+//       The hand-written BFS, Dijkstra and A* loops that BestFirst.h replaced against the
+//       engine's instantiations on an open map and a maze (best of `repeat`), checking that
+//       both expand the same nodes; plus A* with LowHTieBreak.
+//   Benchmark batch [--sizes 64,256,1024] [--maps maze,random:10,random:30] [--seeds 3]
+//                   [--queries 100] [--repeat 3] [--solvers A*,jpsPlus,...] [--csv file] [--json file]
+//       Runs every solver (the SOLVERS table plus jpsBits, jpsPlus and HPA*) on `seeds` seeded maps
+//       of each size and kind, timing each query `repeat` times. Sizes are N (for NxN) or RxC;
+//       maps are "maze", a MazeGenerator name with optional knockout % ("prim", "kruskal:10")
+//       or "random:P" (open field with P% obstacles). Reports median/p95/p99 latency, mean
+//       nodes expanded (split by side for the bidirectional solvers in CSV/JSON), pushes/pops,
+//       preprocessing memory and peak RSS, one row per size/map/solver, and optionally writes
+//       the rows as CSV and JSON.
+//   Benchmark generate [rows cols seed knockout]
+//       Times every MazeGenerator algorithm on one map (default 10000x10000).
+//   Benchmark hpa [rows cols queries seed cluster edits maps]
+//       HPA* against astar on each map (default 1024x1024, "maze,random:20"): hierarchy
+//       build time and memory, query time, nodes and path length over optimal, then the
+//       mean cost of HPAGraph::update after each of `edits` single-cell flips compared
+//       with a full rebuild.
+//   Benchmark dstar [rows cols rounds seed edits map]
+//       Incremental replanning: for each batch size in `edits` (default "1,10,100,1000"), an
+//       agent walks a DStarLite plan across the map (default 1024x1024 "random:20"), and
+//       each round flips that many random cells and replans. Every replan is timed
+//       against astar from scratch on the same map, and its path cost is checked. Each
+//       batch also carries edits outside the map, which must leave the grid border intact.
+//   Benchmark parallelbfs [rows cols maps seed threads repeat]
+//       Strong scaling of ParallelBfs: one corner-to-corner search per map (default
+//       4000x4000, "random:20,maze") with bfs and then 1, 2, 4, ... up to `threads` workers,
+//       best of `repeat` runs. Every parallel parent tree is checked against bfs.
+//   Benchmark mapload [rows cols seed map | file.map]
+//       Startup time of a map (default 4096x4096 "random:20", or a MovingAI .map file):
+//       parsing the MovingAI text format against opening the memory-mapped .pfm and
+//       expanding its wall layer, and building JPS+ against attaching the stored table.
+//   Benchmark cache [rows cols queries distinct seed threads capacity]
+//       A* on `queries` repeats of `distinct` start/goal pairs (some cut short at a cell on
+//       their path, some reversed) with and without a shared PathCache, checking every
+//       cached cost, then an edit that must invalidate the cache and one during a search
+//       whose result must not be stored.
+//   Benchmark distances [rows cols sources targets seed threads map]
+//       A sources x targets distance matrix (default 32x32 on 1024x1024 "random:20") from
+//       one astar call per pair against DistanceTable::manyToMany with 1, 2, 4, ... up to
+//       `threads` workers; every table entry is checked against astar.
+//   Benchmark profile [rows cols queries seed map]
+//       Where each solver's time goes (default 512x512 "random:20"): per-query reset,
+//       search and path-reconstruction time, pushes, pops, stale pops, isValid calls, jump
+//       steps and first-move lookups. Everything but time, pushes and pops needs
+//       -DPATHFINDER_PROFILE. Maps of at most 128x128 cells also profile a 4-connected
+//       first-move table, whose all-pairs build is too slow for larger ones.
+//   Benchmark allocs [rows cols queries seed map]
+//       Counts heap allocations (a replaced operator new) per query of every solver on one
+//       SearchContext (default 256x256 "random:20"): a first pass warms the context's
+//       workspace up, and the second must make none. Exits with 1 if any solver allocates.
+//   Benchmark cpd [rows cols queries seed threads maps]
+//       Compressed first-move tables (FirstMoveTable) on each map (default 128x128,
+//       "maze,random:20"): build time on `threads` workers, runs and bytes per open cell,
+//       save/load of the table, then query latency including the path of astar against the
+//       4-connected table and of jps against the octile one (corner cutting, as jps moves),
+//       checking every path cost.
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <queue>
+#include <sstream>
+#include "Pathfinder.h"
+#include "BestFirst.h"
+#include "Parallel.h"
+#include "BitGrid.h"
+#include "JPSPlus.h"
+#include "MazeGenerator.h"
+#include "ParallelBfs.h"
+#include "HPAStar.h"
+#include "DStarLite.h"
+#include "MapFile.h"
+#include "PathCache.h"
+#include "DistanceTable.h"
+#include "FirstMoveTable.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+// Every heap allocation of the process, counted for "Benchmark allocs"
+static atomic<long long> allocations(0);
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+void* operator new(size_t size, align_val_t align) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    size_t a = static_cast<size_t>(align);
+#ifdef _WIN32
+    if (void* p = _aligned_malloc(size ? size : 1, a)) return p;
+#else
+    if (void* p = aligned_alloc(a, (size + a - 1) / a * a)) return p;
+#endif
+    throw bad_alloc();
+}
+
+// The array and sized forms must be replaced too, or a delete that the compiler sizes
+// would reach the library's version of a block this file allocated
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new[](size_t size, align_val_t align) { return operator new(size, align); }
+
+void operator delete(void* p) noexcept { free(p); }
+
+void operator delete(void* p, align_val_t) noexcept {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete(void* p, size_t, align_val_t align) noexcept { operator delete(p, align); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, align_val_t align) noexcept { operator delete(p, align); }
+void operator delete[](void* p, size_t, align_val_t align) noexcept { operator delete(p, align); }
+
+typedef pair<Point, Point> Query;
+
+// Returns the integer argument at position i, or fallback if it wasn't given
+static int intArg(int argc, char* argv[], int i, int fallback) {
+    return i < argc ? atoi(argv[i]) : fallback;
+}
+
+// Looks a solver up by name (case-sensitive, as printed in the comparison table)
+static const SolverInfo* findSolver(const string& name) {
+    for (int i = 0; i < NUM_SOLVERS; ++i)
+        if (name == SOLVERS[i].name) return &SOLVERS[i];
+    return nullptr;
+}
+
+// Picks `count` start/goal pairs uniformly among the open cells of the grid
+static vector<Query> randomQueries(const Grid& grid, int count, unsigned seed) {
+    vector<Point> open;
+    for (int i = 0; i < grid.rows(); ++i)
+        for (int j = 0; j < grid.cols(); ++j)
+            if (grid.at(i, j) != WALL) open.push_back(Point(i, j));
+
+    mt19937 rng(seed);
+    uniform_int_distribution<size_t> pick(0, open.size() - 1);
+    vector<Query> queries(count);
+    for (Query& q : queries) q = Query(open[pick(rng)], open[pick(rng)]);
+    return queries;
+}
+
+// Serves the same query set with an increasing number of worker threads
+static int runThroughput(int argc, char* argv[]) {
+    int rows = intArg(argc, argv, 0, 256);
+    int cols = intArg(argc, argv, 1, 256);
+    int count = intArg(argc, argv, 2, 2000);
+    const SolverInfo* solver = findSolver(argc > 3 ? argv[3] : "A*");
+    unsigned seed = static_cast<unsigned>(intArg(argc, argv, 4, 1));
+    if (!solver) {
+        cerr << "Unknown solver '" << argv[3] << "'" << endl;
+        return 1;
+    }
+
+    Grid grid;
+    guaranteeSolvableMaze(grid, rows, cols, seed);
+    vector<Query> queries = randomQueries(grid, count, seed);
+
+    int maxThreads = max(1, intArg(argc, argv, 5, defaultThreadCount()));
+    vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    cout << "Throughput: " << solver->name << " on " << rows << "x" << cols << ", "
+        << count << " queries, up to " << maxThreads << " threads" << endl;
+    cout << left << setw(10) << "Threads" << setw(14) << "Time (ms)" << setw(16) << "Queries/sec"
+        << setw(10) << "Speedup" << setw(12) << "Efficiency" << "Nodes" << endl;
+    cout << string(70, '-') << endl;
+
+    double baseline = 0;
+    for (int threads : threadCounts) {
+        vector<SearchContext> contexts(threads, SearchContext(grid));
+        vector<long long> explored(threads, 0);
+
+        auto start_time = chrono::steady_clock::now();
+        parallelFor(count, threads, [&](int i, int worker) {
+            SearchContext& ctx = contexts[worker];
+            ctx.start = queries[i].first;
+            ctx.goal = queries[i].second;
+            solver->solve(ctx, nullptr);
+            explored[worker] += ctx.stats.nodesExplored;
+        });
+        auto end_time = chrono::steady_clock::now();
+
+        double seconds = chrono::duration<double>(end_time - start_time).count();
+        double qps = count / seconds;
+        if (threads == 1) baseline = qps;
+        long long nodes = 0;
+        for (long long n : explored) nodes += n;
+
+        cout << left << setw(10) << threads
+            << setw(14) << fixed << setprecision(1) << seconds * 1000
+            << setw(16) << setprecision(0) << qps
+            << setw(10) << setprecision(2) << qps / baseline
+            << setw(12) << qps / baseline / threads
+            << nodes << endl;
+    }
+    return 0;
+}
+
+// Fills a rows x cols grid with open cells only
+static void openField(Grid& grid, int rows, int cols) {
+    grid.resize(rows, cols);
+    for (int i = 0; i < rows; ++i)
+        for (int j = 0; j < cols; ++j)
+            grid.at(i, j) = PATH;
+}
+
+// Times one solver/open-list combination over the query set and prints a table row
+template <class OpenList>
+static void timeOpenList(const char* mapName, const char* solverName, const char* policy,
+    bool (*solve)(SearchContext&, OpenList&, SearchObserver*),
+    const Grid& grid, const vector<Query>& queries) {
+    SearchContext ctx(grid);
+    OpenList open;
+    long long pushes = 0, pops = 0, cost = 0;
+
+    auto start_time = chrono::steady_clock::now();
+    for (const Query& q : queries) {
+        ctx.start = q.first;
+        ctx.goal = q.second;
+        if (solve(ctx, open, nullptr)) cost += ctx.node(grid.index(q.second.x, q.second.y)).g;
+        pushes += ctx.stats.pushes;
+        pops += ctx.stats.pops;
+    }
+    auto end_time = chrono::steady_clock::now();
+
+    cout << left << setw(8) << mapName << setw(11) << solverName << setw(10) << policy
+        << setw(12) << fixed << setprecision(1) << chrono::duration<double, milli>(end_time - start_time).count()
+        << setw(13) << pushes << setw(13) << pops << cost << endl;
+}
+
+// Runs one solver with every open-list policy
+#define TIME_ALL_POLICIES(mapName, solverName, solver, grid, queries) \
+    timeOpenList<BinaryHeapOpenList>(mapName, solverName, "binary", solver, grid, queries); \
+    timeOpenList<BucketQueue>(mapName, solverName, "bucket", solver, grid, queries); \
+    timeOpenList<RadixHeap>(mapName, solverName, "radix", solver, grid, queries); \
+    timeOpenList<QuaternaryHeap>(mapName, solverName, "4-ary", solver, grid, queries);
+
+// Compares the open-list policies on an open map and on a maze
+static int runOpenList(int argc, char* argv[]) {
+    int rows = intArg(argc, argv, 0, 256);
+    int cols = intArg(argc, argv, 1, 256);
+    int count = intArg(argc, argv, 2, 200);
+    unsigned seed = static_cast<unsigned>(intArg(argc, argv, 3, 1));
+
+    Grid open, maze;
+    openField(open, rows, cols);
+    guaranteeSolvableMaze(maze, rows, cols, seed);
+
+    cout << "Open lists on " << rows << "x" << cols << ", " << count << " queries per row" << endl;
+    cout << left << setw(8) << "Map" << setw(11) << "Solver" << setw(10) << "Open list" << setw(12) << "Time (ms)"
+        << setw(13) << "Pushes" << setw(13) << "Pops" << "Total cost" << endl;
+    cout << string(78, '-') << endl;
+
+    const Grid* grids[] = { &open, &maze };
+    const char* names[] = { "open", "maze" };
+    for (int m = 0; m < 2; ++m) {
+        vector<Query> queries = randomQueries(*grids[m], count, seed);
+        TIME_ALL_POLICIES(names[m], "Dijkstra", dijkstra, *grids[m], queries)
+        TIME_ALL_POLICIES(names[m], "A*", astar, *grids[m], queries)
+        TIME_ALL_POLICIES(names[m], "JumpPoint", jps, *grids[m], queries)
+    }
+    return 0;
+}
+
+// Runs a JPS variant over the query set; returns milliseconds and fills nodes/cost totals
+template <class Solve>
+static double timeJps(const Grid& grid, const vector<Query>& queries, Solve solve, long long& nodes, long long& cost) {
+    SearchContext ctx(grid);
+    nodes = cost = 0;
+    auto start_time = chrono::steady_clock::now();
+    for (const Query& q : queries) {
+        ctx.start = q.first;
+        ctx.goal = q.second;
+        if (solve(ctx)) cost += ctx.node(grid.index(q.second.x, q.second.y)).g;
+        nodes += ctx.stats.nodesExplored;
+    }
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+}
+
+// Prints one row of the JPS comparison
+static void printJpsRow(const char* map, const char* solver, double ms, double baselineMs,
+    long long nodes, long long cost, long long baselineCost, double buildMs, size_t bytes) {
+    cout << left << setw(8) << map << setw(11) << solver << setw(12) << fixed << setprecision(1) << ms
+        << setw(10) << setprecision(2) << baselineMs / ms << setw(13) << nodes << setw(13) << cost;
+    if (bytes) cout << setprecision(1) << buildMs << " / " << bytes / 1024;
+    else cout << "-";
+    cout << (cost == baselineCost ? "" : "  COST MISMATCH") << endl;
+}
+
+// Scalar jps versus bit-parallel jpsBits and table-driven jpsPlus on the same queries
+static int runJps(int argc, char* argv[]) {
+    int rows = intArg(argc, argv, 0, 1024);
+    int cols = intArg(argc, argv, 1, 1024);
+    int count = intArg(argc, argv, 2, 200);
+    unsigned seed = static_cast<unsigned>(intArg(argc, argv, 3, 1));
+
+    Grid open, maze;
+    openField(open, rows, cols);
+    guaranteeSolvableMaze(maze, rows, cols, seed);
+
+    cout << "JPS variants on " << rows << "x" << cols << ", " << count << " queries per row" << endl;
+    cout << left << setw(8) << "Map" << setw(11) << "Solver" << setw(12) << "Time (ms)" << setw(10) << "Speedup"
+        << setw(13) << "Nodes" << setw(13) << "Total cost" << "Build (ms) / Memory (KB)" << endl;
+    cout << string(90, '-') << endl;
+
+    const Grid* grids[] = { &open, &maze };
+    const char* names[] = { "open", "maze" };
+    for (int m = 0; m < 2; ++m) {
+        const Grid& grid = *grids[m];
+        vector<Query> queries = randomQueries(grid, count, seed);
+
+        auto build_start = chrono::steady_clock::now();
+        BitGrid bits(grid);
+        double bitsBuildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - build_start).count();
+
+        build_start = chrono::steady_clock::now();
+        JPSPlusTable table;
+        table.build(grid);
+        double tableBuildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - build_start).count();
+
+        long long nodes, cost, bitNodes, bitCost, plusNodes, plusCost;
+        double scalarMs = timeJps(grid, queries, [&](SearchContext& ctx) { return jps(ctx); }, nodes, cost);
+        double bitMs = timeJps(grid, queries, [&](SearchContext& ctx) { return jpsBits(ctx, bits); }, bitNodes, bitCost);
+        double plusMs = timeJps(grid, queries, [&](SearchContext& ctx) { return jpsPlus(ctx, table); }, plusNodes, plusCost);
+
+        printJpsRow(names[m], "jps", scalarMs, scalarMs, nodes, cost, cost, 0, 0);
+        printJpsRow(names[m], "jpsBits", bitMs, scalarMs, bitNodes, bitCost, cost, bitsBuildMs, bits.memoryBytes());
+        printJpsRow(names[m], "jpsPlus", plusMs, scalarMs, plusNodes, plusCost, cost, tableBuildMs, table.memoryBytes());
+    }
+    return 0;
+}
+
+// The hand-written BFS, Dijkstra and A* loops that bestFirstSearch replaced, kept as the
+// baseline for "Benchmark engine"
+static bool handBfs(SearchContext& ctx) {
+    ctx.reset();
+    const Grid& grid = *ctx.grid;
+    int s = grid.index(ctx.start.x, ctx.start.y);
+    int t = grid.index(ctx.goal.x, ctx.goal.y);
+    queue<int> q;
+    q.push(s);
+    ctx.stats.pushes++;
+    ctx.node(s).visited = true;
+    ctx.node(s).parent = s;
+    ctx.node(s).g = 0;
+
+    while (!q.empty()) {
+        int curr = q.front(); q.pop();
+        ctx.stats.pops++;
+        ctx.stats.nodesExplored++;
+        if (curr == t) return true;
+        for (int i = 0; i < DIRS_4; ++i) {
+            int next = curr + grid.offset4[i];
+            if (!grid.isValid(next)) continue;
+            NodeState& n = ctx.node(next);
+            if (!n.visited) {
+                n.visited = true;
+                n.parent = curr;
+                n.g = ctx.node(curr).g + 1;
+                q.push(next);
+                ctx.stats.pushes++;
+            }
+        }
+    }
+    return false;
+}
+
+template <bool AStar>
+static bool handBestFirst(SearchContext& ctx, BucketQueue& open) {
+    ctx.reset();
+    const Grid& grid = *ctx.grid;
+    int s = grid.index(ctx.start.x, ctx.start.y);
+    int t = grid.index(ctx.goal.x, ctx.goal.y);
+
+    ctx.node(s).g = 0;
+    ctx.node(s).parent = s;
+    open.clear(grid.size());
+    open.push(AStar ? heuristic_manhattan(ctx.start, ctx.goal) : 0, s);
+    ctx.stats.pushes++;
+
+    while (!open.empty()) {
+        int curr = open.pop();
+        ctx.stats.pops++;
+        NodeState& c = ctx.node(curr);
+        if (c.visited) continue;
+        c.visited = true;
+        ctx.stats.nodesExplored++;
+        if (curr == t) return true;
+
+        for (int i = 0; i < DIRS_4; ++i) {
+            int next = curr + grid.offset4[i];
+            if (!grid.isValid(next)) continue;
+            NodeState& n = ctx.node(next);
+            int tentative_g = c.g + 1;
+            if (tentative_g < n.g) {
+                n.g = tentative_g;
+                n.parent = curr;
+                open.push(tentative_g + (AStar ? heuristic_manhattan(grid.point(next), ctx.goal) : 0), next);
+                ctx.stats.pushes++;
+            }
+        }
+    }
+    return false;
+}
+
+// Hand-written loops against their bestFirstSearch instantiations on an open map and a
+// maze; every pair must agree on nodes, pushes, pops and cost
+static int runEngine(int argc, char* argv[]) {
+    int rows = intArg(argc, argv, 0, 512);
+    int cols = intArg(argc, argv, 1, 512);
+    int count = intArg(argc, argv, 2, 200);
+    unsigned seed = static_cast<unsigned>(intArg(argc, argv, 3, 1));
+    int repeat = max(1, intArg(argc, argv, 4, 3));
+
+    Grid open, maze;
+    openField(open, rows, cols);
+    guaranteeSolvableMaze(maze, rows, cols, seed);
+
+    cout << "Best-first engine on " << rows << "x" << cols << ", " << count << " queries, best of " << repeat << endl;
+    cout << left << setw(8) << "Map" << setw(10) << "Solver" << setw(14) << "Hand (ms)" << setw(14) << "Engine (ms)"
+        << setw(10) << "Ratio" << setw(13) << "Nodes" << "Total cost" << endl;
+    cout << string(80, '-') << endl;
+
+    const Grid* grids[] = { &open, &maze };
+    const char* names[] = { "open", "maze" };
+    for (int m = 0; m < 2; ++m) {
+        const Grid& grid = *grids[m];
+        vector<Query> queries = randomQueries(grid, count, seed);
+        BucketQueue bucket;
+        BinaryHeapOpenList heap;
+        FifoQueue fifo;
+
+        // One run over the queries, with stats summed into totals
+        auto measure = [&](function<bool(SearchContext&)> solve, SearchStats& totals, long long& cost) {
+            SearchContext ctx(grid);
+            totals = SearchStats();
+            cost = 0;
+            auto start_time = chrono::steady_clock::now();
+            for (const Query& q : queries) {
+                ctx.start = q.first;
+                ctx.goal = q.second;
+                if (solve(ctx)) cost += ctx.node(grid.index(q.second.x, q.second.y)).g;
+                totals.nodesExplored += ctx.stats.nodesExplored;
+                totals.pushes += ctx.stats.pushes;
+                totals.pops += ctx.stats.pops;
+            }
+            return chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+        };
+        auto row = [&](const char* solver, function<bool(SearchContext&)> hand, function<bool(SearchContext&)> engine) {
+            SearchStats handStats, engineStats;
+            long long handCost = 0, engineCost = 0;
+            // Alternate the two so drift in machine load hits both alike; keep the best run of each
+            double handMs = 1e300, engineMs = 1e300;
+            for (int r = 0; r < repeat; ++r) {
+                if (hand) handMs = min(handMs, measure(hand, handStats, handCost));
+                engineMs = min(engineMs, measure(engine, engineStats, engineCost));
+            }
+            bool same = !hand || (handStats.nodesExplored == engineStats.nodesExplored && handStats.pushes == engineStats.pushes
+                && handStats.pops == engineStats.pops && handCost == engineCost);
+            cout << left << setw(8) << names[m] << setw(10) << solver << fixed << setprecision(1);
+            if (hand) cout << setw(14) << handMs;
+            else cout << setw(14) << "-";
+            cout << setw(14) << engineMs << setw(10) << setprecision(2);
+            if (hand) cout << engineMs / handMs;
+            else cout << "-";
+            cout << setw(13) << engineStats.nodesExplored << engineCost << (same ? "" : "  MISMATCH") << endl;
+        };
+
+        row("BFS", handBfs, [&](SearchContext& ctx) { return bestFirstSearch(ctx, fifo, UniformCost(), ZeroHeuristic()); });
+        row("Dijkstra", [&](SearchContext& ctx) { return handBestFirst<false>(ctx, bucket); },
+            [&](SearchContext& ctx) { return bestFirstSearch(ctx, bucket, UniformCost(), ZeroHeuristic()); });
+        row("A*", [&](SearchContext& ctx) { return handBestFirst<true>(ctx, bucket); },
+            [&](SearchContext& ctx) { return bestFirstSearch(ctx, bucket, UniformCost(), ModelHeuristic<UniformCost>{ UniformCost() }); });
+        row("A* low-h", nullptr, [&](SearchContext& ctx) {
+            return bestFirstSearch<LowHTieBreak>(ctx, heap, UniformCost(), ModelHeuristic<UniformCost>{ UniformCost() });
+        });
+    }
+    return 0;
+}
+
+// Peak resident set size of this process in KB (0 if unavailable)
+static long peakMemoryKB() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return 0;
+    return static_cast<long>(pmc.PeakWorkingSetSize / 1024);
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return static_cast<long>(usage.ru_maxrss / 1024); // bytes on macOS
+#else
+    return static_cast<long>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+// Returns the value following --name, or fallback if the flag wasn't given
+static string flagArg(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 0; i + 1 < argc; ++i)
+        if (argv[i] == "--" + name) return argv[i + 1];
+    return fallback;
+}
+
+// Splits a comma-separated list
+static vector<string> splitList(const string& list) {
+    vector<string> items;
+    stringstream in(list);
+    string item;
+    while (getline(in, item, ','))
+        if (!item.empty()) items.push_back(item);
+    return items;
+}
+
+// Dijkstra and A* under each cost model from CostModel.h, with jps for the octile rows
+static int runCosts(int argc, char* argv[]) {
+    int rows = intArg(argc, argv, 0, 512);
+    int cols = intArg(argc, argv, 1, 512);
+    int count = intArg(argc, argv, 2, 100);
+    unsigned seed = static_cast<unsigned>(intArg(argc, argv, 3, 1));
+    int maxWeight = min(255, max(1, intArg(argc, argv, 4, 8)));
+
+    Grid grid;
+    buildMap(grid, "random:20", rows, cols, seed);
+    TerrainMap terrain;
+    terrain.build(grid);
+    mt19937 rng(seed);
+    uniform_int_distribution<int> pickWeight(1, maxWeight);
+    for (int x = 0; x < rows; ++x)
+        for (int y = 0; y < cols; ++y)
+            terrain.set(x, y, static_cast<uint8_t>(pickWeight(rng)));
+    vector<Query> queries = randomQueries(grid, count, seed);
+
+    cout << "Cost models on random:20 " << rows << "x" << cols << ", terrain weights 1-" << maxWeight
+        << ", " << count << " queries per row" << endl;
+    cout << left << setw(22) << "Model" << setw(11) << "Solver" << setw(12) << "Time (ms)" << setw(13) << "Nodes"
+        << "Mean cost (steps)" << endl;
+    cout << string(75, '-') << endl;
+
+    // unit is what one straight step of weight 1 costs under the model
+    auto row = [&](const char* model, const char* solver, int unit, function<bool(SearchContext&)> solve) {
+        long long nodes, cost;
+        double ms = timeJps(grid, queries, solve, nodes, cost);
+        cout << left << setw(22) << model << setw(11) << solver << setw(12) << fixed << setprecision(1) << ms
+            << setw(13) << nodes << setprecision(2) << double(cost) / unit / max(1, count) << endl;
+    };
+    auto both = [&](const char* model, int unit, auto cost) {
+        BucketQueue open;
+        row(model, "Dijkstra", unit, [&](SearchContext& ctx) { return dijkstra(ctx, open, cost); });
+        row(model, "A*", unit, [&](SearchContext& ctx) { return astar(ctx, open, cost); });
+    };
+    both("uniform", 1, UniformCost());
+    both("terrain", COST_ONE, TerrainCost(terrain));
+    both("octile, no cut", COST_ONE, OctileCost(CornerRule::NoCut));
+    both("octile, cut", COST_ONE, OctileCost(CornerRule::Cut));
+    row("octile, cut", "jps", COST_ONE, [](SearchContext& ctx) { return jps(ctx); });
+    both("octile + terrain", COST_ONE, OctileCost(CornerRule::NoCut, &terrain));
+    return 0;
+}
+
+// A* that then edits the map, as another thread might while a search runs
+static Grid* editDuringSearch = nullptr;
+static bool astarThenEdit(SearchContext& ctx, SearchObserver* observer) {
+    bool found = astar(ctx, observer);
+    editDuringSearch->markEdited();
+    return found;
+}
+
+// Repeated and near-duplicate queries with and without a shared PathCache
+static int runCache(int argc, char* argv[]) {
+    int rows = intArg(argc, argv, 0, 512);
+    int cols = intArg(argc, argv, 1, 512);
+    int count = intArg(argc, argv, 2, 5000);
+    int distinct = max(1, intArg(argc, argv, 3, 200));
+    unsigned seed = static_cast<unsigned>(intArg(argc, argv, 4, 1));
+    int threads = max(1, intArg(argc, argv, 5, defaultThreadCount()));
+    int capacity = max(1, intArg(argc, argv, 6, 4096));
+
+    Grid grid;
+    buildMap(grid, "random:20", rows, cols, seed);
+
+    // Each query repeats one of `distinct` pairs; a third of them stop early at a cell on
+    // that pair's path and a quarter run backwards, as agents heading the same way would
+    vector<Query> pairs = randomQueries(grid, distinct, seed);
+    vector<vector<Point>> routes(distinct);
+    SearchContext ctx(grid);
+    for (int i = 0; i < distinct; ++i) {
+        ctx.start = pairs[i].first;
+        ctx.goal = pairs[i].second;
+        if (astar(ctx)) routes[i] = reconstructPath(ctx, ctx.goal);
+    }
+    mt19937 rng(seed);
+    vector<Query> queries(count);
+    for (Query& q : queries) {
+        int i = static_cast<int>(rng() % distinct);
+        q = pairs[i];
+        if (rng() % 3 == 0 && !routes[i].empty()) q.second = routes[i][rng() % routes[i].size()];
+        if (rng() % 4 == 0) swap(q.first, q.second);
+    }
+
+    cout << "Path cache: A* on random:20 " << rows << "x" << cols << ", " << count << " queries over " << distinct
+        << " pairs, " << threads << " threads, capacity " << capacity << endl;
+    cout << left << setw(10) << "Mode" << setw(12) << "Time (ms)" << setw(14) << "Queries/sec" << setw(10) << "Speedup"
+        << setw(10) << "Hits" << setw(13) << "Sub-paths" << setw(10) << "Misses" << "Cost check" << endl;
+    cout << string(85, '-') << endl;
+
+    vector<SearchContext> contexts(threads, SearchContext(grid));
+    vector<int> costs(count, -1);
+    auto start_time = chrono::steady_clock::now();
+    parallelFor(count, threads, [&](int i, int worker) {
+        SearchContext& c = contexts[worker];
+        c.start = queries[i].first;
+        c.goal = queries[i].second;
+        if (astar(c)) costs[i] = c.node(grid.index(c.goal.x, c.goal.y)).g;
+    });
+    double plainMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+    cout << left << setw(10) << "uncached" << setw(12) << fixed << setprecision(1) << plainMs
+        << setw(14) << setprecision(0) << count / plainMs * 1000 << setw(10) << setprecision(2) << 1.0 << endl;
+
+    PathCache cache(grid, capacity);
+    atomic<int> wrong(0);
+    start_time = chrono::steady_clock::now();
+    parallelFor(count, threads, [&](int i, int worker) {
+        SearchContext& c = contexts[worker];
+        c.start = queries[i].first;
+        c.goal = queries[i].second;
+        CachedPath result = cache.findPath(c, astar);
+        if ((result.found ? result.cost : -1) != costs[i]) wrong++;
+    });
+    double cachedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+    cout << left << setw(10) << "cached" << setw(12) << fixed << setprecision(1) << cachedMs
+        << setw(14) << setprecision(0) << count / cachedMs * 1000 << setw(10) << setprecision(2) << plainMs / cachedMs
+        << setw(10) << cache.hits() << setw(13) << cache.subpathHits() << setw(10) << cache.misses()
+        << (wrong ? to_string(wrong) + " WRONG" : "ok") << endl;
+
+    // An edit bumps the grid version, so the next query finds the cache empty
+    char& cell = grid.at(queries[0].first.x, queries[0].first.y);
+    cell = PATH;
+    grid.markEdited();
+    ctx.start = queries[0].first;
+    ctx.goal = queries[0].second;
+    uint64_t missesBefore = cache.misses();
+    cache.findPath(ctx, astar);
+    cout << "After a map edit: " << cache.invalidations() << " invalidation, "
+        << (cache.misses() > missesBefore ? "miss" : "HIT ON STALE ENTRY") << ", " << cache.size() << " entry left" << endl;
+
+    // A result the map changed under while it was searched must not be stored
+    editDuringSearch = &grid;
+    ctx.start = queries[1].first;
+    ctx.goal = queries[1].second;
+    cache.findPath(ctx, astarThenEdit);
+    bool dropped = cache.size() == 0;
+    cout << "Edit during a search: " << (dropped ? "result not cached" : "STALE RESULT CACHED") << endl;
+    return wrong || !dropped ? 1 : 0;
+}
+
+// Many-to-many distance tables against one astar call per (source, target) pair
+static int runDistances(int argc, char* argv[]) {
+    int rows = intArg(argc, argv, 0, 1024);
+    int cols = intArg(argc, argv, 1, 1024);
+    int sourceCount = max(1, intArg(argc, argv, 2, 32));
+    int targetCount = max(1, intArg(argc, argv, 3, 32));
+    unsigned seed = static_cast<unsigned>(intArg(argc, argv, 4, 1));
+    int maxThreads = max(1, intArg(argc, argv, 5, defaultThreadCount()));
+    string map = argc > 6 ? argv[6] : "random:20";
+
+    Grid grid;
+    if (!buildMap(grid, map, rows, cols, seed)) {
+        cerr << "Unknown map '" << map << "'" << endl;
+        return 1;
+    }
+    vector<Query> picks = randomQueries(grid, max(sourceCount, targetCount), seed);
+    vector<Point> sources, targets;
+    for (int i = 0; i < sourceCount; ++i) sources.push_back(picks[i].first);
+    for (int j = 0; j < targetCount; ++j) targets.push_back(picks[j].second);
+
+    cout << "Distance tables: " << sourceCount << " x " << targetCount << " on " << map << " " << rows << "x" << cols << endl;
+    cout << left << setw(24) << "Method" << setw(10) << "Threads" << setw(12) << "Time (ms)" << setw(10) << "Speedup"
+        << setw(14) << "Nodes" << "Check" << endl;
+    cout << string(76, '-') << endl;
+
+    // Baseline: N*M independent searches
+    SearchContext ctx(grid);
+    vector<int> expected(sources.size() * targets.size());
+    long long nodes = 0;
+    auto start_time = chrono::steady_clock::now();
+    for (size_t i = 0; i < sources.size(); ++i) {
+        for (size_t j = 0; j < targets.size(); ++j) {
+            ctx.start = sources[i];
+            ctx.goal = targets[j];
+            expected[i * targets.size() + j] = astar(ctx) ? ctx.node(grid.index(targets[j].x, targets[j].y)).g : -1;
+            nodes += ctx.stats.nodesExplored;
+        }
+    }
+    double astarMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+    cout << left << setw(24) << "astar per pair" << setw(10) << 1 << setw(12) << fixed << setprecision(1) << astarMs
+        << setw(10) << setprecision(2) << 1.0 << setw(14) << nodes << endl;
+
+    vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+    for (int threads : threadCounts) {
+        DistanceTable<> table(grid, UniformCost(), threads);
+        vector<int> distances;
+        start_time = chrono::steady_clock::now();
+        table.manyToMany(sources, targets, distances);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+        cout << left << setw(24) << "manyToMany (BFS sweeps)" << setw(10) << threads << setw(12) << setprecision(1) << ms
+            << setw(10) << setprecision(2) << astarMs / ms << setw(14) << table.nodesSettled()
+            << (distances == expected ? "ok" : "MISMATCH") << endl;
+        if (distances != expected) return 1;
+    }
+    return 0;
+}
+
+// Per-query breakdown of where each solver spends its time, from the counters and phase
+// timers of Profile.h (all but time, pushes and pops read 0 without PATHFINDER_PROFILE)
+static int runProfile(int argc, char* argv[]) {
+    int rows = intArg(argc, argv, 0, 512);
+    int cols = intArg(argc, argv, 1, 512);
+    int count = max(1, intArg(argc, argv, 2, 200));
+    unsigned seed = static_cast<unsigned>(intArg(argc, argv, 3, 1));
+    string map = argc > 4 ? argv[4] : "random:20";
+
+    Grid grid;
+    if (!buildMap(grid, map, rows, cols, seed)) {
+        cerr << "Unknown map '" << map << "'" << endl;
+        return 1;
+    }
+    vector<Query> queries = randomQueries(grid, count, seed);
+    BitGrid bits(grid);
+    JPSPlusTable table;
+    table.build(grid);
+    HPAGraph hierarchy;
+    hierarchy.build(grid, 16);
+
+    vector<pair<string, function<bool(SearchContext&)>>> solvers;
+    for (int i = 0; i < NUM_SOLVERS; ++i) {
+        Solver solve = SOLVERS[i].solve;
+        solvers.push_back({ SOLVERS[i].name, [solve](SearchContext& ctx) { return solve(ctx, nullptr); } });
+    }
+    solvers.push_back({ "jpsBits", [&](SearchContext& ctx) { return jpsBits(ctx, bits); } });
+    solvers.push_back({ "jpsPlus", [&](SearchContext& ctx) { return jpsPlus(ctx, table); } });
+    FirstMoveTable<UniformCost> firstMoves;
+    if (rows * cols <= 128 * 128) {
+        firstMoves.build(grid, defaultThreadCount());
+        solvers.push_back({ "cpd 4-conn", [&](SearchContext& ctx) { return firstMovePath(ctx, firstMoves); } });
+    }
+
+    cout << "Per-query profile on " << map << " " << rows << "x" << cols << ", " << count << " queries";
+    cout << (PROFILE_ENABLED ? "" : " (counters off: build with -DPATHFINDER_PROFILE)") << endl;
+    cout << left << setw(12) << "Solver" << setw(10) << "Total us" << setw(10) << "Reset us" << setw(11) << "Search us"
+        << setw(11) << "Path us" << setw(10) << "Pushes" << setw(10) << "Pops" << setw(10) << "Stale" << setw(12) << "isValid"
+        << setw(9) << "Jumps" << setw(12) << "Jump steps" << "Lookups" << endl;
+    cout << string(125, '-') << endl;
+
+    SearchContext ctx(grid);
+    for (auto& solver : solvers) {
+        uint64_t totalTicks = 0;
+        SearchProfile sum;
+        long long pushes = 0, pops = 0;
+        for (const Query& q : queries) {
+            ctx.start = q.first;
+            ctx.goal = q.second;
+            uint64_t t0 = profileTicks();
+            bool found = solver.second(ctx);
+            if (found && !(q.first == q.second)) reconstructPath(ctx, ctx.goal);
+            totalTicks += profileTicks() - t0;
+
+            pushes += ctx.stats.pushes;
+            pops += ctx.stats.pops;
+            sum.stalePops += ctx.profile.stalePops;
+            sum.isValidCalls += ctx.profile.isValidCalls;
+            sum.jumpCalls += ctx.profile.jumpCalls;
+            sum.jumpSteps += ctx.profile.jumpSteps;
+            sum.firstMoveLookups += ctx.profile.firstMoveLookups;
+            sum.resetTicks += ctx.profile.resetTicks;
+            sum.reconstructTicks += ctx.profile.reconstructTicks;
+        }
+        double totalUs = profileMicroseconds(totalTicks) / count;
+        double resetUs = profileMicroseconds(sum.resetTicks) / count;
+        double pathUs = profileMicroseconds(sum.reconstructTicks) / count;
+        cout << left << setw(12) << solver.first << fixed << setprecision(1) << setw(10) << totalUs
+            << setprecision(2) << setw(10) << resetUs << setprecision(1) << setw(11) << totalUs - resetUs - pathUs
+            << setprecision(2) << setw(11) << pathUs << setprecision(0)
+            << setw(10) << static_cast<double>(pushes) / count << setw(10) << static_cast<double>(pops) / count
+            << setw(10) << static_cast<double>(sum.stalePops) / count << setw(12) << static_cast<double>(sum.isValidCalls) / count
+            << setw(9) << static_cast<double>(sum.jumpCalls) / count << setw(12) << static_cast<double>(sum.jumpSteps) / count
+            << static_cast<double>(sum.firstMoveLookups) / count << endl;
+    }
+    return 0;
+}
+
+// Heap allocations per query of every solver on a warmed-up SearchContext: one pass over
+// the queries sizes the context's workspace, the second must not allocate at all
+static int runAllocs(int argc, char* argv[]) {
+    int rows = intArg(argc, argv, 0, 256);
+    int cols = intArg(argc, argv, 1, 256);
+    int count = max(1, intArg(argc, argv, 2, 200));
+    unsigned seed = static_cast<unsigned>(intArg(argc, argv, 3, 1));
+    string map = argc > 4 ? argv[4] : "random:20";
+
+    Grid grid;
+    if (!buildMap(grid, map, rows, cols, seed)) {
+        cerr << "Unknown map '" << map << "'" << endl;
+        return 1;
+    }
+    vector<Query> queries = randomQueries(grid, count, seed);
+    BitGrid bits(grid);
+    JPSPlusTable table;
+    table.build(grid);
+    HPAGraph hierarchy;
+    hierarchy.build(grid, 16);
+
+    vector<pair<string, function<bool(SearchContext&)>>> solvers;
+    for (int i = 0; i < NUM_SOLVERS; ++i) {
+        Solver solve = SOLVERS[i].solve;
+        solvers.push_back({ SOLVERS[i].name, [solve](SearchContext& ctx) { return solve(ctx, nullptr); } });
+    }
+    solvers.push_back({ "jpsBits", [&](SearchContext& ctx) { return jpsBits(ctx, bits); } });
+    solvers.push_back({ "jpsPlus", [&](SearchContext& ctx) { return jpsPlus(ctx, table); } });
+    solvers.push_back({ "HPA*", [&](SearchContext& ctx) { return hpaStar(ctx, hierarchy); } });
+
+    cout << "Heap allocations per query on " << map << " " << rows << "x" << cols << ", " << count
+        << " queries (solve + reconstructPath into ctx.path)" << endl;
+    cout << left << setw(12) << "Solver" << setw(14) << "First pass" << "Warmed up" << endl;
+    cout << string(36, '-') << endl;
+
+    bool clean = true;
+    for (auto& solver : solvers) {
+        SearchContext ctx(grid);
+        long long counts[2];
+        for (int pass = 0; pass < 2; ++pass) {
+            long long before = allocations.load();
+            for (const Query& q : queries) {
+                ctx.start = q.first;
+                ctx.goal = q.second;
+                if (solver.second(ctx)) reconstructPath(ctx, ctx.goal, ctx.path);
+            }
+            counts[pass] = allocations.load() - before;
+        }
+        clean = clean && counts[1] == 0;
+        cout << left << setw(12) << solver.first << fixed << setprecision(2) << setw(14)
+            << static_cast<double>(counts[0]) / count << static_cast<double>(counts[1]) / count << endl;
+    }
+    cout << (clean ? "No allocations after warm-up" : "FAILED: allocations after warm-up") << endl;
+    return clean ? 0 : 1;
+}
+
+// Samples and totals for one size/map/solver row, gathered over all seeds
+struct BatchRow {
+    int rows = 0, cols = 0;
+    string map, solver;
+    vector<double> micros; // One latency sample per run
+    long long found = 0;   // Queries with a path (counted once, not per repeat)
+    long long nodes = 0, pushes = 0, pops = 0;
+    long long forward = 0, backward = 0; // Bidirectional solvers: nodes expanded per side
+    size_t auxBytes = 0;   // Largest preprocessing structure (BitGrid, JPS+ table)
+    long peakKB = 0;       // Process peak RSS once the row finished
+};
+
+// Nearest-rank percentile of sorted samples
+static double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t rank = static_cast<size_t>(p * sorted.size() + 0.999999);
+    return sorted[min(sorted.size(), max<size_t>(rank, 1)) - 1];
+}
+
+// Summary figures of a finished row
+struct BatchSummary {
+    double median, p95, p99, mean;
+    double nodes, pushes, pops;
+    double forward, backward;
+};
+
+static BatchSummary summarize(BatchRow& row) {
+    BatchSummary s = {};
+    vector<double>& t = row.micros;
+    sort(t.begin(), t.end());
+    double runs = t.empty() ? 1 : static_cast<double>(t.size());
+    double total = 0;
+    for (double us : t) total += us;
+    s.median = percentile(t, 0.50);
+    s.p95 = percentile(t, 0.95);
+    s.p99 = percentile(t, 0.99);
+    s.mean = total / runs;
+    s.nodes = row.nodes / runs;
+    s.pushes = row.pushes / runs;
+    s.pops = row.pops / runs;
+    s.forward = row.forward / runs;
+    s.backward = row.backward / runs;
+    return s;
+}
+
+static void writeCsv(const string& path, vector<BatchRow>& rows) {
+    ofstream out(path);
+    out << "rows,cols,map,solver,runs,found,median_us,p95_us,p99_us,mean_us,nodes,nodes_forward,nodes_backward,"
+        "pushes,pops,aux_kb,peak_rss_kb\n";
+    out << fixed << setprecision(2);
+    for (BatchRow& r : rows) {
+        BatchSummary s = summarize(r);
+        out << r.rows << ',' << r.cols << ',' << r.map << ',' << r.solver << ',' << r.micros.size() << ','
+            << r.found << ',' << s.median << ',' << s.p95 << ',' << s.p99 << ',' << s.mean << ','
+            << s.nodes << ',' << s.forward << ',' << s.backward << ',' << s.pushes << ',' << s.pops << ','
+            << r.auxBytes / 1024 << ',' << r.peakKB << '\n';
+    }
+    if (!out) cerr << "Could not write " << path << endl;
+}
+
+static void writeJson(const string& path, vector<BatchRow>& rows, int seeds, int queries, int repeat) {
+    ofstream out(path);
+    out << fixed << setprecision(2);
+    out << "{\n  \"seeds\": " << seeds << ", \"queries\": " << queries << ", \"repeat\": " << repeat
+        << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        BatchRow& r = rows[i];
+        BatchSummary s = summarize(r);
+        out << "    {\"rows\": " << r.rows << ", \"cols\": " << r.cols << ", \"map\": \"" << r.map
+            << "\", \"solver\": \"" << r.solver << "\", \"runs\": " << r.micros.size() << ", \"found\": " << r.found
+            << ", \"median_us\": " << s.median << ", \"p95_us\": " << s.p95 << ", \"p99_us\": " << s.p99
+            << ", \"mean_us\": " << s.mean << ", \"nodes\": " << s.nodes << ", \"nodes_forward\": " << s.forward
+            << ", \"nodes_backward\": " << s.backward << ", \"pushes\": " << s.pushes
+            << ", \"pops\": " << s.pops << ", \"aux_kb\": " << r.auxBytes / 1024
+            << ", \"peak_rss_kb\": " << r.peakKB << "}" << (i + 1 < rows.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    if (!out) cerr << "Could not write " << path << endl;
+}
+
+// Many seeded maps across sizes and kinds, every solver, latency percentiles per row
+static int runBatch(int argc, char* argv[]) {
+    vector<string> sizes = splitList(flagArg(argc, argv, "sizes", "64,256,1024"));
+    vector<string> maps = splitList(flagArg(argc, argv, "maps", "maze,random:10,random:30"));
+    int seeds = max(1, atoi(flagArg(argc, argv, "seeds", "3").c_str()));
+    int count = max(1, atoi(flagArg(argc, argv, "queries", "100").c_str()));
+    int repeat = max(1, atoi(flagArg(argc, argv, "repeat", "3").c_str()));
+    vector<string> only = splitList(flagArg(argc, argv, "solvers", ""));
+    string csvPath = flagArg(argc, argv, "csv", "");
+    string jsonPath = flagArg(argc, argv, "json", "");
+
+    // Solvers run in this order; the preprocessed ones read bits/table, rebuilt per map
+    Grid grid;
+    BitGrid bits;
+    JPSPlusTable table;
+    HPAGraph hierarchy;
+    vector<pair<string, function<bool(SearchContext&)>>> solvers;
+    for (int i = 0; i < NUM_SOLVERS; ++i) {
+        Solver solve = SOLVERS[i].solve;
+        solvers.push_back({ SOLVERS[i].name, [solve](SearchContext& ctx) { return solve(ctx, nullptr); } });
+    }
+    solvers.push_back({ "jpsBits", [&](SearchContext& ctx) { return jpsBits(ctx, bits); } });
+    solvers.push_back({ "jpsPlus", [&](SearchContext& ctx) { return jpsPlus(ctx, table); } });
+    solvers.push_back({ "HPA*", [&](SearchContext& ctx) { return hpaStar(ctx, hierarchy); } });
+    if (!only.empty()) {
+        for (const string& name : only) {
+            bool known = false;
+            for (const auto& s : solvers) known = known || s.first == name;
+            if (!known) {
+                cerr << "Unknown solver '" << name << "'" << endl;
+                return 1;
+            }
+        }
+        solvers.erase(remove_if(solvers.begin(), solvers.end(), [&](const pair<string, function<bool(SearchContext&)>>& s) {
+            return find(only.begin(), only.end(), s.first) == only.end();
+        }), solvers.end());
+    }
+
+    for (const string& size : sizes) {
+        size_t x = size.find('x');
+        if (atoi(size.c_str()) <= 0 || (x != string::npos && atoi(size.c_str() + x + 1) <= 0)) {
+            cerr << "Bad size '" << size << "'" << endl;
+            return 1;
+        }
+    }
+    for (const string& map : maps) {
+        if (!buildMap(grid, map, 1, 1, 1)) {
+            cerr << "Unknown map '" << map << "'" << endl;
+            return 1;
+        }
+    }
+
+    // Name columns fit the longest name plus a separating space
+    int mapWidth = 11, solverWidth = 10;
+    for (const string& map : maps) mapWidth = max(mapWidth, static_cast<int>(map.size()) + 1);
+    for (const auto& s : solvers) solverWidth = max(solverWidth, static_cast<int>(s.first.size()) + 1);
+
+    cout << "Batch: " << seeds << " seeds x " << count << " queries x " << repeat << " runs per size/map/solver" << endl;
+    cout << left << setw(11) << "Size" << setw(mapWidth) << "Map" << setw(solverWidth) << "Solver" << setw(8) << "Found"
+        << setw(11) << "Median us" << setw(11) << "p95 us" << setw(11) << "p99 us" << setw(11) << "Nodes"
+        << setw(11) << "Pushes" << setw(11) << "Pops" << setw(10) << "Aux KB" << "Peak KB" << endl;
+    cout << string(102 + mapWidth + solverWidth, '-') << endl;
+
+    vector<BatchRow> results;
+    for (const string& size : sizes) {
+        int rows = atoi(size.c_str());
+        size_t x = size.find('x');
+        int cols = x == string::npos ? rows : atoi(size.c_str() + x + 1);
+
+        for (const string& map : maps) {
+            size_t first = results.size();
+            for (const auto& s : solvers) {
+                BatchRow row;
+                row.rows = rows;
+                row.cols = cols;
+                row.map = map;
+                row.solver = s.first;
+                row.micros.reserve(static_cast<size_t>(seeds) * count * repeat);
+                results.push_back(row);
+            }
+
+            for (int seed = 1; seed <= seeds; ++seed) {
+                buildMap(grid, map, rows, cols, seed);
+                bits.build(grid);
+                table.build(grid);
+                hierarchy.build(grid);
+                vector<Query> queries = randomQueries(grid, count, seed);
+                SearchContext ctx(grid);
+
+                for (size_t k = 0; k < solvers.size(); ++k) {
+                    BatchRow& row = results[first + k];
+                    if (solvers[k].first == "jpsBits") row.auxBytes = max(row.auxBytes, bits.memoryBytes());
+                    if (solvers[k].first == "jpsPlus") row.auxBytes = max(row.auxBytes, table.memoryBytes());
+                    if (solvers[k].first == "HPA*") row.auxBytes = max(row.auxBytes, hierarchy.memoryBytes());
+
+                    for (const Query& q : queries) {
+                        for (int r = 0; r < repeat; ++r) {
+                            ctx.start = q.first;
+                            ctx.goal = q.second;
+                            auto start_time = chrono::steady_clock::now();
+                            bool found = solvers[k].second(ctx);
+                            auto end_time = chrono::steady_clock::now();
+                            row.micros.push_back(chrono::duration<double, micro>(end_time - start_time).count());
+                            if (r == 0) row.found += found;
+                            row.nodes += ctx.stats.nodesExplored;
+                            row.pushes += ctx.stats.pushes;
+                            row.pops += ctx.stats.pops;
+                            row.forward += ctx.stats.expandedForward;
+                            row.backward += ctx.stats.expandedBackward;
+                        }
+                    }
+                    row.peakKB = peakMemoryKB();
+                }
+            }
+
+            for (size_t k = first; k < results.size(); ++k) {
+                BatchRow& r = results[k];
+                BatchSummary s = summarize(r);
+                cout << left << setw(11) << size << setw(mapWidth) << r.map << setw(solverWidth) << r.solver
+                    << setw(8) << r.found << fixed << setprecision(1)
+                    << setw(11) << s.median << setw(11) << s.p95 << setw(11) << s.p99
+                    << setprecision(0) << setw(11) << s.nodes << setw(11) << s.pushes << setw(11) << s.pops
+                    << setw(10) << r.auxBytes / 1024 << r.peakKB << endl;
+            }
+        }
+    }
+
+    if (!csvPath.empty()) writeCsv(csvPath, results);
+    if (!jsonPath.empty()) writeJson(jsonPath, results, seeds, count, repeat);
+    return 0;
+}
+
+// Times each generator on one large map
+static int runGenerate(int argc, char* argv[]) {
+    int rows = intArg(argc, argv, 0, 10000);
+    int cols = intArg(argc, argv, 1, 10000);
+    unsigned seed = static_cast<unsigned>(intArg(argc, argv, 2, 1));
+    int knockout = intArg(argc, argv, 3, 40);
+
+    cout << "Generators on " << rows << "x" << cols << ", seed " << seed << ", " << knockout << "% knockout" << endl;
+    cout << left << setw(14) << "Algorithm" << setw(12) << "Time (ms)" << "Open cells" << endl;
+    cout << string(40, '-') << endl;
+
+    Grid grid;
+    const MazeAlgorithm algorithms[] = { MazeAlgorithm::Backtracker, MazeAlgorithm::Prim,
+        MazeAlgorithm::Kruskal, MazeAlgorithm::OpenField };
+    for (MazeAlgorithm algorithm : algorithms) {
+        MazeOptions options;
+        options.seed = seed;
+        options.rows = rows;
+        options.cols = cols;
+        options.knockoutPercent = knockout;
+        options.algorithm = algorithm;
+
+        auto start_time = chrono::steady_clock::now();
+        generateMaze(grid, options);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+
+        long long open = 0;
+        for (int i = 0; i < rows; ++i)
+            for (int j = 0; j < cols; ++j) open += grid.at(i, j) != WALL;
+        cout << left << setw(14) << mazeAlgorithmName(algorithm) << setw(12) << fixed << setprecision(1) << ms
+            << open << endl;
+    }
+    return 0;
+}
+
+// HPA* query cost, path quality and incremental update cost against astar and full rebuilds
+static int runHpa(int argc, char* argv[]) {
+    int rows = intArg(argc, argv, 0, 1024);
+    int cols = intArg(argc, argv, 1, 1024);
+    int count = intArg(argc, argv, 2, 200);
+    unsigned seed = static_cast<unsigned>(intArg(argc, argv, 3, 1));
+    int clusterSize = intArg(argc, argv, 4, 16);
+    int edits = intArg(argc, argv, 5, 200);
+    vector<string> maps = splitList(argc > 6 ? argv[6] : "maze,random:20");
+
+    cout << "HPA* on " << rows << "x" << cols << ", " << clusterSize << "x" << clusterSize << " clusters, "
+        << count << " queries, " << edits << " edits" << endl;
+    cout << left << setw(11) << "Map" << setw(10) << "Solver" << setw(12) << "Time (ms)" << setw(10) << "Speedup"
+        << setw(12) << "Nodes" << setw(12) << "Path +%" << "Build (ms) / Memory (KB)" << endl;
+    cout << string(90, '-') << endl;
+
+    Grid grid;
+    for (const string& map : maps) {
+        if (!buildMap(grid, map, rows, cols, seed)) {
+            cerr << "Unknown map '" << map << "'" << endl;
+            return 1;
+        }
+        vector<Query> queries = randomQueries(grid, count, seed);
+
+        auto build_start = chrono::steady_clock::now();
+        HPAGraph hierarchy;
+        hierarchy.build(grid, clusterSize);
+        double buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - build_start).count();
+
+        long long nodes, cost, hpaNodes, hpaCost;
+        double astarMs = timeJps(grid, queries, [&](SearchContext& ctx) { return astar(ctx); }, nodes, cost);
+        double hpaMs = timeJps(grid, queries, [&](SearchContext& ctx) { return hpaStar(ctx, hierarchy); }, hpaNodes, hpaCost);
+
+        cout << left << setw(11) << map << setw(10) << "A*" << setw(12) << fixed << setprecision(1) << astarMs
+            << setw(10) << setprecision(2) << 1.0 << setw(12) << nodes << setw(12) << "-" << "-" << endl;
+        cout << left << setw(11) << map << setw(10) << "HPA*" << setw(12) << fixed << setprecision(1) << hpaMs
+            << setw(10) << setprecision(2) << astarMs / hpaMs << setw(12) << hpaNodes
+            << setw(12) << (cost ? 100.0 * (hpaCost - cost) / cost : 0.0)
+            << setprecision(1) << buildMs << " / " << hierarchy.memoryBytes() / 1024 << endl;
+
+        // Flip random interior cells one at a time, updating after each
+        mt19937 rng(seed);
+        uniform_int_distribution<int> pickRow(0, rows - 1), pickCol(0, cols - 1);
+        double updateMs = 0;
+        long long clusters = 0;
+        for (int e = 0; e < edits; ++e) {
+            Point p(pickRow(rng), pickCol(rng));
+            char& c = grid.at(p.x, p.y);
+            if (c == START || c == END) continue;
+            c = c == WALL ? PATH : WALL;
+            auto update_start = chrono::steady_clock::now();
+            hierarchy.update(grid, vector<Point>(1, p));
+            updateMs += chrono::duration<double, milli>(chrono::steady_clock::now() - update_start).count();
+            clusters += hierarchy.clustersRebuilt();
+        }
+        build_start = chrono::steady_clock::now();
+        HPAGraph rebuilt;
+        rebuilt.build(grid, clusterSize);
+        double rebuildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - build_start).count();
+        cout << left << setw(11) << map << "update: " << setprecision(3) << updateMs / max(1, edits)
+            << " ms per edit (" << setprecision(1) << double(clusters) / max(1, edits) << " clusters), full rebuild "
+            << rebuildMs << " ms" << (hierarchy.nodeCount() == rebuilt.nodeCount() ? "" : "  NODE COUNT MISMATCH") << endl;
+    }
+    return 0;
+}
+
+// True if every cell of the grid's padding is still WALL
+static bool borderIntact(const Grid& grid) {
+    for (int x = -1; x <= grid.rows(); ++x)
+        if (grid[grid.index(x, -1)] != WALL || grid[grid.index(x, grid.cols())] != WALL) return false;
+    for (int y = -1; y <= grid.cols(); ++y)
+        if (grid[grid.index(-1, y)] != WALL || grid[grid.index(grid.rows(), y)] != WALL) return false;
+    return true;
+}
+
+// DStarLite replans after batches of random edits against astar from scratch; every batch
+// also carries edits outside the map, which must change nothing
+static int runDStar(int argc, char* argv[]) {
+    int rows = intArg(argc, argv, 0, 1024);
+    int cols = intArg(argc, argv, 1, 1024);
+    int rounds = max(1, intArg(argc, argv, 2, 50));
+    unsigned seed = static_cast<unsigned>(intArg(argc, argv, 3, 1));
+    vector<string> batches = splitList(argc > 4 ? argv[4] : "1,10,100,1000");
+    string map = argc > 5 ? argv[5] : "random:20";
+
+    Grid grid;
+    if (!buildMap(grid, map, rows, cols, seed)) {
+        cerr << "Unknown map '" << map << "'" << endl;
+        return 1;
+    }
+    cout << "D* Lite on " << map << " " << rows << "x" << cols << ", " << rounds << " rounds per batch size" << endl;
+    cout << left << setw(8) << "Edits" << setw(14) << "Replan (ms)" << setw(14) << "A* (ms)" << setw(10) << "Speedup"
+        << setw(15) << "Replan nodes" << setw(12) << "A* nodes" << "Initial plan (ms)" << endl;
+    cout << string(90, '-') << endl;
+
+    for (const string& batch : batches) {
+        int edits = max(0, atoi(batch.c_str()));
+        buildMap(grid, map, rows, cols, seed);
+        SearchContext ctx(grid);
+        DStarLite planner(grid);
+        Point start(0, 0), goal(rows - 1, cols - 1);
+
+        auto start_time = chrono::steady_clock::now();
+        planner.plan(start, goal);
+        double planMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+
+        mt19937 rng(seed);
+        uniform_int_distribution<int> pickRow(0, rows - 1), pickCol(0, cols - 1);
+        double replanMs = 0, astarMs = 0;
+        long long replanNodes = 0, astarNodes = 0;
+        for (int r = 0; r < rounds; ++r) {
+            // The agent walks a few cells along its plan before the map changes
+            vector<Point> path = planner.path();
+            if (path.size() > 1) {
+                start = path[min<size_t>(5, path.size() - 1)];
+                planner.moveStart(start);
+            }
+            vector<CellEdit> batchEdits;
+            for (int e = 0; e < edits; ++e)
+                batchEdits.push_back({ Point(pickRow(rng), pickCol(rng)), rng() % 2 == 0 });
+            // Edits off the map must be skipped, leaving the WALL border intact
+            batchEdits.push_back({ Point(-1, pickCol(rng)), false });
+            batchEdits.push_back({ Point(pickRow(rng), cols), false });
+            batchEdits.push_back({ Point(rows + 1000000, -1000000), false });
+            planner.applyEdits(batchEdits);
+            if (!borderIntact(grid)) {
+                cerr << "applyEdits opened a cell of the grid border" << endl;
+                return 1;
+            }
+
+            start_time = chrono::steady_clock::now();
+            bool found = planner.replan();
+            replanMs += chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+            replanNodes += planner.stats.nodesExplored;
+
+            ctx.start = start;
+            ctx.goal = goal;
+            start_time = chrono::steady_clock::now();
+            bool astarFound = astar(ctx);
+            astarMs += chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+            astarNodes += ctx.stats.nodesExplored;
+
+            int cost = astarFound ? ctx.node(grid.index(goal.x, goal.y)).g : -1;
+            if (found != astarFound || planner.pathCost() != cost) {
+                cerr << "D* Lite path cost " << planner.pathCost() << " differs from A* " << cost << endl;
+                return 1;
+            }
+        }
+        cout << left << setw(8) << edits << setw(14) << fixed << setprecision(3) << replanMs / rounds
+            << setw(14) << astarMs / rounds << setw(10) << setprecision(2) << astarMs / replanMs
+            << setw(15) << replanNodes / rounds << setw(12) << astarNodes / rounds
+            << setprecision(1) << planMs << endl;
+    }
+    return 0;
+}
+
+// Checks the labelling left by ParallelBfs: the start at distance 0, every other labelled
+// cell one step further than its parent, and no edge between labelled cells or into an
+// unlabelled one skipping a level (unlabelled neighbours are only allowed on the last level)
+static bool validBfsTree(const SearchContext& ctx) {
+    const Grid& grid = *ctx.grid;
+    int s = grid.index(ctx.start.x, ctx.start.y);
+    int deepest = 0;
+    for (int idx = 0; idx < grid.size(); ++idx)
+        if (ctx.touched(idx)) deepest = max(deepest, ctx.nodes[idx].g);
+
+    for (int idx = 0; idx < grid.size(); ++idx) {
+        if (!ctx.touched(idx)) continue;
+        const NodeState& n = ctx.nodes[idx];
+        if (idx == s ? n.g != 0 || n.parent != s
+                     : !ctx.touched(n.parent) || ctx.nodes[n.parent].g != n.g - 1)
+            return false;
+        bool adjacent = idx == s;
+        for (int d = 0; d < DIRS_4; ++d) {
+            int next = idx + grid.offset4[d];
+            adjacent = adjacent || next == n.parent;
+            if (!grid.isValid(next)) continue;
+            if (ctx.touched(next) ? abs(ctx.nodes[next].g - n.g) > 1 : n.g != deepest) return false;
+        }
+        if (!adjacent) return false;
+    }
+    return true;
+}
+
+// Serial bfs against ParallelBfs with a growing number of workers
+static int runParallelBfs(int argc, char* argv[]) {
+    int rows = intArg(argc, argv, 0, 4000);
+    int cols = intArg(argc, argv, 1, 4000);
+    vector<string> maps = splitList(argc > 2 ? argv[2] : "random:20,maze");
+    unsigned seed = static_cast<unsigned>(intArg(argc, argv, 3, 1));
+    int maxThreads = max(1, intArg(argc, argv, 4, defaultThreadCount()));
+    int repeat = max(1, intArg(argc, argv, 5, 3));
+
+    vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    cout << "Parallel BFS: " << rows << "x" << cols << ", (0, 0) to (" << rows - 1 << ", " << cols - 1
+        << "), best of " << repeat << ", up to " << maxThreads << " threads" << endl;
+    cout << left << setw(12) << "Map" << setw(10) << "Solver" << setw(10) << "Threads" << setw(12) << "Time (ms)"
+        << setw(10) << "Speedup" << setw(12) << "Efficiency" << setw(12) << "Nodes" << setw(11) << "Bottom-up"
+        << "Distance" << endl;
+    cout << string(96, '-') << endl;
+
+    Grid grid;
+    for (const string& map : maps) {
+        if (!buildMap(grid, map, rows, cols, seed)) {
+            cerr << "Unknown map '" << map << "'" << endl;
+            return 1;
+        }
+        SearchContext ctx(grid);
+        ctx.start = Point(0, 0);
+        ctx.goal = Point(rows - 1, cols - 1);
+
+        double serialMs = 1e300;
+        bool found = false;
+        for (int r = 0; r < repeat; ++r) {
+            auto start_time = chrono::steady_clock::now();
+            found = bfs(ctx);
+            serialMs = min(serialMs, chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count());
+        }
+        int distance = found ? static_cast<int>(reconstructPath(ctx, ctx.goal).size()) + 1 : -1;
+        cout << left << setw(12) << map << setw(10) << "bfs" << setw(10) << 1
+            << setw(12) << fixed << setprecision(1) << serialMs << setw(10) << setprecision(2) << 1.0
+            << setw(12) << "" << setw(12) << ctx.stats.nodesExplored << setw(11) << "" << distance << endl;
+
+        for (int threads : threadCounts) {
+            ParallelBfs search(threads);
+            search.build(grid);
+            double ms = 1e300;
+            for (int r = 0; r < repeat; ++r) {
+                auto start_time = chrono::steady_clock::now();
+                found = search.search(ctx);
+                ms = min(ms, chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count());
+            }
+            int parallelDistance = found ? ctx.nodes[grid.index(ctx.goal.x, ctx.goal.y)].g : -1;
+            if (parallelDistance != distance || !validBfsTree(ctx)) {
+                cerr << "ParallelBfs with " << threads << " threads returned a wrong parent tree on " << map << endl;
+                return 1;
+            }
+            cout << left << setw(12) << map << setw(10) << "parallel" << setw(10) << threads
+                << setw(12) << fixed << setprecision(1) << ms << setw(10) << setprecision(2) << serialMs / ms
+                << setw(12) << serialMs / ms / threads << setw(12) << ctx.stats.nodesExplored
+                << setw(11) << search.bottomUpLevels() << parallelDistance << endl;
+        }
+    }
+    return 0;
+}
+
+// Startup cost of a map: MovingAI text parsing against the memory-mapped .pfm format,
+// and building the JPS+ table against attaching the copy stored in the file
+static int runMapLoad(int argc, char* argv[]) {
+    Grid grid;
+    string source;
+    if (argc == 1) {
+        source = argv[0];
+        if (!importMovingAiMap(source, grid)) {
+            cerr << "Cannot read MovingAI map '" << source << "'" << endl;
+            return 1;
+        }
+    }
+    else {
+        int rows = intArg(argc, argv, 0, 4096);
+        int cols = intArg(argc, argv, 1, 4096);
+        unsigned seed = static_cast<unsigned>(intArg(argc, argv, 2, 1));
+        source = argc > 3 ? argv[3] : "random:20";
+        if (!buildMap(grid, source, rows, cols, seed)) {
+            cerr << "Unknown map '" << source << "'" << endl;
+            return 1;
+        }
+    }
+    Point start(0, 0), goal(grid.rows() - 1, grid.cols() - 1);
+    JPSPlusTable built;
+    built.build(grid);
+
+    string textPath = "mapload_tmp.map", binaryPath = "mapload_tmp.pfm";
+    if (!exportMovingAiMap(textPath, grid) || !saveMap(binaryPath, grid, start, goal, &built)) {
+        cerr << "Cannot write temporary map files" << endl;
+        return 1;
+    }
+    cout << "Map load: " << source << " " << grid.rows() << "x" << grid.cols() << endl;
+
+    auto start_time = chrono::steady_clock::now();
+    Grid parsed;
+    bool ok = importMovingAiMap(textPath, parsed);
+    double textMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+
+    start_time = chrono::steady_clock::now();
+    MapFile file;
+    ok = file.open(binaryPath) && ok;
+    double openMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+    Grid loaded;
+    if (ok) loadGrid(file, loaded);
+    double binaryMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+
+    start_time = chrono::steady_clock::now();
+    JPSPlusTable rebuilt;
+    rebuilt.build(parsed);
+    double buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+    start_time = chrono::steady_clock::now();
+    JPSPlusTable attached;
+    ok = ok && attachJpsPlus(file, loaded, attached);
+    double attachMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+
+    // Both copies must describe the same walls, and the attached table must match a fresh build
+    for (int x = 0; ok && x < grid.rows(); ++x)
+        for (int y = 0; ok && y < grid.cols(); ++y)
+            ok = (parsed.at(x, y) == WALL) == (grid.at(x, y) == WALL) && (loaded.at(x, y) == WALL) == (grid.at(x, y) == WALL);
+    ok = ok && memcmp(attached.data(), rebuilt.data(), rebuilt.entryCount() * sizeof(int32_t)) == 0;
+
+    ifstream textFile(textPath, ios::binary | ios::ate);
+    double textMB = textFile.tellg() / 1048576.0;
+    textFile.close();
+    double binaryMB = file.fileBytes() / 1048576.0;
+    remove(textPath.c_str());
+    remove(binaryPath.c_str());
+    if (!ok) {
+        cerr << "Loaded maps differ from the source map" << endl;
+        return 1;
+    }
+
+    double wallMB = static_cast<double>(grid.rows()) * file.rowWords() * sizeof(uint64_t) / 1048576.0;
+    cout << fixed << setprecision(2) << "Files: .map " << textMB << " MB, .pfm " << binaryMB << " MB (walls "
+        << wallMB << " MB, JPS+ " << binaryMB - wallMB << " MB)" << endl;
+    cout << left << setw(30) << "Step" << "Time (ms)" << endl;
+    cout << string(40, '-') << endl;
+    cout << left << setw(30) << "text .map parse" << textMs << endl;
+    cout << left << setw(30) << ".pfm mmap open" << openMs << endl;
+    cout << left << setw(30) << ".pfm open + loadGrid" << binaryMs << endl;
+    cout << left << setw(30) << "JPS+ build" << buildMs << endl;
+    cout << left << setw(30) << "JPS+ attach from .pfm" << attachMs << endl;
+    cout << "Grid startup " << setprecision(1) << textMs / binaryMs << "x faster; with JPS+ "
+        << (textMs + buildMs) / (binaryMs + attachMs) << "x faster" << endl;
+    return 0;
+}
+
+// First-move table build, size and path extraction against the search it replaces
+static int runCpd(int argc, char* argv[]) {
+    int rows = intArg(argc, argv, 0, 128);
+    int cols = intArg(argc, argv, 1, 128);
+    int count = intArg(argc, argv, 2, 1000);
+    unsigned seed = static_cast<unsigned>(intArg(argc, argv, 3, 1));
+    int threads = max(1, intArg(argc, argv, 4, defaultThreadCount()));
+    vector<string> maps = splitList(argc > 5 ? argv[5] : "maze,random:20");
+
+    cout << "First-move tables on " << rows << "x" << cols << ", " << threads << " build threads, "
+        << count << " queries per row (time includes the path)" << endl;
+    cout << left << setw(11) << "Map" << setw(12) << "Solver" << setw(12) << "Time (ms)" << setw(13) << "us/query"
+        << setw(10) << "Speedup" << setw(12) << "Nodes" << "Build (ms) / Runs / Bytes per cell / Load (ms)" << endl;
+    cout << string(110, '-') << endl;
+
+    bool ok = true;
+    Grid grid;
+    for (const string& map : maps) {
+        if (!buildMap(grid, map, rows, cols, seed)) {
+            cerr << "Unknown map '" << map << "'" << endl;
+            return 1;
+        }
+        vector<Query> queries = randomQueries(grid, count, seed);
+
+        // Builds, saves and reloads a table, then times it against the baseline search
+        auto compare = [&](const char* baselineName, auto baseline, const char* name, auto cost) {
+            typedef decltype(cost) Cost;
+            auto build_start = chrono::steady_clock::now();
+            FirstMoveTable<Cost> built(cost);
+            built.build(grid, threads);
+            double buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - build_start).count();
+
+            string path = "cpd_tmp.cpd";
+            FirstMoveTable<Cost> table(cost);
+            bool saved = built.save(path);
+            build_start = chrono::steady_clock::now();
+            bool loaded = saved && table.load(path, grid);
+            double loadMs = chrono::duration<double, milli>(chrono::steady_clock::now() - build_start).count();
+            remove(path.c_str());
+            if (!loaded) {
+                cerr << "Cannot save and reload the " << name << " table" << endl;
+                ok = false;
+                return;
+            }
+
+            long long nodes, total, cpdNodes, cpdTotal;
+            double baseMs = timeJps(grid, queries, [&](SearchContext& ctx) {
+                bool found = baseline(ctx);
+                if (found) reconstructPath(ctx, ctx.goal, ctx.path);
+                return found;
+            }, nodes, total);
+            double cpdMs = timeJps(grid, queries, [&](SearchContext& ctx) {
+                bool found = firstMovePath(ctx, table);
+                if (found) reconstructPath(ctx, ctx.goal, ctx.path);
+                return found;
+            }, cpdNodes, cpdTotal);
+
+            cout << left << setw(11) << map << setw(12) << baselineName << setw(12) << fixed << setprecision(1) << baseMs
+                << setw(13) << setprecision(2) << 1000 * baseMs / max(1, count) << setw(10) << 1.0 << setw(12) << nodes << "-" << endl;
+            cout << left << setw(11) << map << setw(12) << name << setw(12) << setprecision(1) << cpdMs
+                << setw(13) << setprecision(2) << 1000 * cpdMs / max(1, count) << setw(10) << baseMs / cpdMs
+                << setw(12) << cpdNodes << setprecision(1) << buildMs << " / " << table.runCount() << " / "
+                << setprecision(2) << double(table.memoryBytes()) / max(1, table.openCells()) << " / "
+                << loadMs << (cpdTotal == total ? "" : "  COST MISMATCH") << endl;
+            ok = ok && cpdTotal == total;
+        };
+        compare("A*", [](SearchContext& ctx) { return astar(ctx); }, "cpd 4-conn", UniformCost());
+        compare("jps", [](SearchContext& ctx) { return jps(ctx); }, "cpd octile", OctileCost(CornerRule::Cut));
+    }
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    string mode = argc > 1 ? argv[1] : "";
+    if (mode == "throughput") return runThroughput(argc - 2, argv + 2);
+    if (mode == "openlist") return runOpenList(argc - 2, argv + 2);
+    if (mode == "jps") return runJps(argc - 2, argv + 2);
+    if (mode == "costs") return runCosts(argc - 2, argv + 2);
+    if (mode == "engine") return runEngine(argc - 2, argv + 2);
+    if (mode == "batch") return runBatch(argc - 2, argv + 2);
+    if (mode == "generate") return runGenerate(argc - 2, argv + 2);
+    if (mode == "hpa") return runHpa(argc - 2, argv + 2);
+    if (mode == "dstar") return runDStar(argc - 2, argv + 2);
+    if (mode == "parallelbfs") return runParallelBfs(argc - 2, argv + 2);
+    if (mode == "mapload") return runMapLoad(argc - 2, argv + 2);
+    if (mode == "cache") return runCache(argc - 2, argv + 2);
+    if (mode == "distances") return runDistances(argc - 2, argv + 2);
+    if (mode == "profile") return runProfile(argc - 2, argv + 2);
+    if (mode == "allocs") return runAllocs(argc - 2, argv + 2);
+    if (mode == "cpd") return runCpd(argc - 2, argv + 2);
+
+    cerr << "Usage: Benchmark throughput [rows cols queries solver seed threads]" << endl;
+    cerr << "       Benchmark openlist [rows cols queries seed]" << endl;
+    cerr << "       Benchmark jps [rows cols queries seed]" << endl;
+    cerr << "       Benchmark costs [rows cols queries seed maxWeight]" << endl;
+    cerr << "       Benchmark engine [rows cols queries seed repeat]" << endl;
+    cerr << "       Benchmark batch [--sizes N|RxC,...] [--maps maze|random:P,...] [--seeds n] [--queries n]" << endl;
+    cerr << "                       [--repeat n] [--solvers name,...] [--csv file] [--json file]" << endl;
+    cerr << "       Benchmark generate [rows cols seed knockout]" << endl;
+    cerr << "       Benchmark hpa [rows cols queries seed cluster edits maps]" << endl;
+    cerr << "       Benchmark dstar [rows cols rounds seed edits map]" << endl;
+    cerr << "       Benchmark parallelbfs [rows cols maps seed threads repeat]" << endl;
+    cerr << "       Benchmark mapload [rows cols seed map | file.map]" << endl;
+    cerr << "       Benchmark cache [rows cols queries distinct seed threads capacity]" << endl;
+    cerr << "       Benchmark distances [rows cols sources targets seed threads map]" << endl;
+    cerr << "       Benchmark profile [rows cols queries seed map]" << endl;
+    cerr << "       Benchmark allocs [rows cols queries seed map]" << endl;
+    cerr << "       Benchmark cpd [rows cols queries seed threads maps]" << endl;
+    return 1;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <type_traits>
+#include "Pathfinder.h"
+#include "CostModel.h"
+
+// Best-first search engine behind bfs, dijkstra and astar. It is templated on:
+//   OpenList   a policy from OpenList.h (FifoQueue turns it into BFS)
+//   Cost       a cost model from CostModel.h: the neighbourhood, move rules and step costs
+//   Heuristic  h(p, goal), consistent with Cost (ZeroHeuristic for Dijkstra and BFS)
+//   TieBreak   how g and h become the open-list key
+// Every policy is resolved at compile time, so the move loop has a constant trip count
+// and the step cost, heuristic and key are inlined into the relaxation.
+
+// No heuristic: Dijkstra, or BFS with FifoQueue
+struct ZeroHeuristic {
+    int operator()(Point, Point) const { return 0; }
+};
+
+// The cost model's own heuristic (Manhattan or octile, scaled to the model's units)
+template <class Cost>
+struct ModelHeuristic {
+    const Cost& cost;
+    int operator()(Point p, Point goal) const { return cost.heuristic(p, goal); }
+};
+
+// Tie-breaking policies: key(g, h) is what the node is pushed with. MONOTONE says whether
+// the keys never drop below the last one popped, which the bucket and radix queues need.
+
+// Plain f = g + h; equal keys pop in the open list's own order
+struct NoTieBreak {
+    static constexpr bool MONOTONE = true;
+    static int key(int g, int h) { return g + h; }
+};
+
+// Among equal f, the smaller h (the node nearer the goal) first, which stops A* from
+// expanding whole plateaus of equal f on open maps. The key is f * 1024 + min(h, 1023),
+// so f must stay below 2^21 and only h below 1024 is told apart.
+struct LowHTieBreak {
+    static constexpr bool MONOTONE = false;
+    static int key(int g, int h) { return ((g + h) << 10) + (h < 1023 ? h : 1023); }
+};
+
+template <class TieBreak = NoTieBreak, class OpenList, class Cost, class Heuristic>
+bool bestFirstSearch(SearchContext& ctx, OpenList& open, const Cost& cost, const Heuristic& heuristic,
+    SearchObserver* observer = nullptr) {
+    static_assert(TieBreak::MONOTONE || !MonotoneKeys<OpenList>::value,
+        "This tie-breaking policy needs an open list that accepts non-monotone keys");
+    const bool needPoints = !std::is_same<Heuristic, ZeroHeuristic>::value;
+
+    ctx.reset();
+    const Grid& grid = *ctx.grid;
+    int& nodesExplored = ctx.stats.nodesExplored;
+    int s = grid.index(ctx.start.x, ctx.start.y);
+    int t = grid.index(ctx.goal.x, ctx.goal.y);
+    int offsets[Cost::DIRS];
+    for (int i = 0; i < Cost::DIRS; ++i) offsets[i] = Cost::DX[i] * grid.stride() + Cost::DY[i];
+
+    ctx.node(s).g = 0;
+    ctx.node(s).parent = s;
+    open.clear(grid.size());
+    open.push(TieBreak::key(0, heuristic(ctx.start, ctx.goal)), s);
+    ctx.stats.pushes++;
+
+    while (!open.empty()) {
+        int curr = open.pop();
+        ctx.stats.pops++;
+        NodeState& c = ctx.node(curr);
+        if (c.visited) {
+            PROFILE_COUNT(stalePops);
+            continue;
+        }
+
+        c.visited = true;
+        nodesExplored++;
+        // Neighbour coordinates are derived from curr's, so a heuristic costs no division
+        Point cp = needPoints || observer ? grid.point(curr) : Point();
+        if (observer) observer->onExpand(cp);
+
+        if (curr == t) return true;
+
+        for (int i = 0; i < Cost::DIRS; ++i) {
+            int next = curr + offsets[i];
+            if (!grid.isValid(next) || !cost.canMove(grid, offsets, curr, i)) continue;
+
+            NodeState& n = ctx.node(next);
+            int g = c.g + cost.step(next, i);
+            if (g < n.g) {
+                n.g = g;
+                n.parent = curr;
+                Point np(cp.x + Cost::DX[i], cp.y + Cost::DY[i]);
+                open.push(TieBreak::key(g, heuristic(np, ctx.goal)), next);
+                ctx.stats.pushes++;
+
+                if (observer) observer->onVisit(np);
+            }
+        }
+    }
+    return false;
+}
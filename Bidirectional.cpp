@@ -0,0 +1,229 @@
+#include "Bidirectional.h"
+
+#include <vector>
+
+using namespace std;
+
+// Side 0 searches from the start over ctx.node, side 1 from the goal over ctx.backNode
+static NodeState& record(SearchContext& ctx, int side, int idx) {
+    return side == 0 ? ctx.node(idx) : ctx.backNode(idx);
+}
+
+// Seeds both searches; returns false if start and goal coincide (nothing left to search)
+static bool startBoth(SearchContext& ctx, int s, int t) {
+    ctx.reset();
+    ctx.prepareBackward();
+    NodeState& from = ctx.node(s);
+    from.g = 0;
+    from.parent = s;
+    NodeState& to = ctx.backNode(t);
+    to.g = 0;
+    to.parent = t;
+    if (s != t) return true;
+    ctx.stats.nodesExplored = ctx.stats.expandedForward = 1;
+    return false;
+}
+
+static void countExpansion(SearchContext& ctx, int side, int idx, SearchObserver* observer) {
+    ctx.stats.nodesExplored++;
+    (side == 0 ? ctx.stats.expandedForward : ctx.stats.expandedBackward)++;
+    if (observer) observer->onExpand(ctx.grid->point(idx));
+}
+
+// Points the forward parents along the backward chain from meet to the goal and fills in
+// their forward costs, so the path reads start -> meet -> goal through ctx.node
+static void joinAt(SearchContext& ctx, int meet, int t) {
+    for (int prev = meet; prev != t;) {
+        int next = ctx.backNode(prev).parent;
+        NodeState& n = ctx.node(next);
+        n.parent = prev;
+        n.g = ctx.node(prev).g + 1;
+        prev = next;
+    }
+}
+
+bool bidirectionalBfs(SearchContext& ctx, SearchObserver* observer) {
+    const Grid& grid = *ctx.grid;
+    int s = grid.index(ctx.start.x, ctx.start.y);
+    int t = grid.index(ctx.goal.x, ctx.goal.y);
+    if (!startBoth(ctx, s, t)) return true;
+
+    vector<int>* frontier = ctx.frontier;
+    vector<int>& next = ctx.frontier[2];
+    frontier[0].assign(1, s);
+    frontier[1].assign(1, t);
+    ctx.node(s).visited = ctx.backNode(t).visited = true;
+    ctx.stats.pushes += 2;
+
+    // With both frontiers one level apart at most, the first cell reached by both sides
+    // lies on a shortest path: anything shorter would have met a level earlier
+    while (!frontier[0].empty() && !frontier[1].empty()) {
+        int side = frontier[0].size() <= frontier[1].size() ? 0 : 1;
+        next.clear();
+        for (int curr : frontier[side]) {
+            ctx.stats.pops++;
+            countExpansion(ctx, side, curr, observer);
+            int g = record(ctx, side, curr).g + 1;
+
+            for (int i = 0; i < DIRS_4; ++i) {
+                int nb = curr + grid.offset4[i];
+                if (!grid.isValid(nb)) continue;
+
+                NodeState& n = record(ctx, side, nb);
+                if (n.visited) continue;
+                n.visited = true;
+                n.g = g;
+                n.parent = curr;
+                next.push_back(nb);
+                ctx.stats.pushes++;
+                if (observer) observer->onVisit(grid.point(nb));
+
+                if (record(ctx, 1 - side, nb).visited) {
+                    joinAt(ctx, nb, t);
+                    return true;
+                }
+            }
+        }
+        // Copied rather than swapped, so each buffer keeps the capacity its own role needs
+        frontier[side].assign(next.begin(), next.end());
+    }
+    return false;
+}
+
+template <class OpenList>
+bool bidirectionalDijkstra(SearchContext& ctx, OpenList& forward, OpenList& backward, SearchObserver* observer) {
+    const Grid& grid = *ctx.grid;
+    int s = grid.index(ctx.start.x, ctx.start.y);
+    int t = grid.index(ctx.goal.x, ctx.goal.y);
+    if (!startBoth(ctx, s, t)) return true;
+
+    OpenList* open[2] = { &forward, &backward };
+    open[0]->clear(grid.size());
+    open[1]->clear(grid.size());
+    open[0]->push(0, s);
+    open[1]->push(0, t);
+    ctx.stats.pushes += 2;
+
+    int radius[2] = { 0, 0 }; // Distance of the last node settled on each side
+    int best = SearchContext::UNREACHED, meet = -1;
+
+    while (!open[0]->empty() && !open[1]->empty()) {
+        int side = radius[0] <= radius[1] ? 0 : 1;
+        int curr = open[side]->pop();
+        ctx.stats.pops++;
+        NodeState& c = record(ctx, side, curr);
+        if (c.visited) {
+            PROFILE_COUNT(stalePops);
+            continue;
+        }
+        c.visited = true;
+        radius[side] = c.g;
+        // Any path not seen yet is at least as long as the two radii together
+        if (radius[0] + radius[1] >= best) break;
+        countExpansion(ctx, side, curr, observer);
+
+        for (int i = 0; i < DIRS_4; ++i) {
+            int nb = curr + grid.offset4[i];
+            if (!grid.isValid(nb)) continue;
+
+            NodeState& n = record(ctx, side, nb);
+            if (n.g > c.g + 1) {
+                n.g = c.g + 1;
+                n.parent = curr;
+                open[side]->push(n.g, nb);
+                ctx.stats.pushes++;
+                if (observer) observer->onVisit(grid.point(nb));
+            }
+            const NodeState& o = record(ctx, 1 - side, nb);
+            if (o.g != SearchContext::UNREACHED && n.g + o.g < best) {
+                best = n.g + o.g;
+                meet = nb;
+            }
+        }
+    }
+
+    if (meet < 0) return false;
+    joinAt(ctx, meet, t);
+    return true;
+}
+
+template <class OpenList>
+bool bidirectionalAstar(SearchContext& ctx, OpenList& forward, OpenList& backward, SearchObserver* observer) {
+    const Grid& grid = *ctx.grid;
+    int s = grid.index(ctx.start.x, ctx.start.y);
+    int t = grid.index(ctx.goal.x, ctx.goal.y);
+    if (!startBoth(ctx, s, t)) return true;
+
+    // Each side estimates the distance to the other side's origin
+    const Point target[2] = { ctx.goal, ctx.start };
+    auto h = [&](int side, int idx) { return heuristic_manhattan(grid.point(idx), target[side]); };
+
+    OpenList* open[2] = { &forward, &backward };
+    open[0]->clear(grid.size());
+    open[1]->clear(grid.size());
+    open[0]->push(h(0, s), s);
+    open[1]->push(h(1, t), t);
+    ctx.stats.pushes += 2;
+
+    int lowestF[2] = { h(0, s), h(1, t) }; // f of the last node popped on each side
+    int best = SearchContext::UNREACHED, meet = -1;
+
+    // A node is closed once either side pops it; closed nodes are never touched again
+    for (int side = 0; !open[0]->empty() && !open[1]->empty(); side ^= 1) {
+        int curr = open[side]->pop();
+        ctx.stats.pops++;
+        NodeState& c = record(ctx, side, curr);
+        if (c.visited || record(ctx, 1 - side, curr).visited) {
+            PROFILE_COUNT(stalePops);
+            continue;
+        }
+        c.visited = true;
+
+        int hc = h(side, curr);
+        lowestF[side] = c.g + hc;
+        // Reject: the node can't lie on a path shorter than best, judged from either end
+        if (c.g + hc >= best || c.g + lowestF[1 - side] - h(1 - side, curr) >= best) continue;
+        countExpansion(ctx, side, curr, observer);
+
+        for (int i = 0; i < DIRS_4; ++i) {
+            int nb = curr + grid.offset4[i];
+            if (!grid.isValid(nb)) continue;
+
+            NodeState& n = record(ctx, side, nb);
+            const NodeState& o = record(ctx, 1 - side, nb);
+            if (n.visited || o.visited) continue;
+            if (n.g > c.g + 1) {
+                n.g = c.g + 1;
+                n.parent = curr;
+                open[side]->push(n.g + h(side, nb), nb);
+                ctx.stats.pushes++;
+                if (observer) observer->onVisit(grid.point(nb));
+                if (o.g != SearchContext::UNREACHED && n.g + o.g < best) {
+                    best = n.g + o.g;
+                    meet = nb;
+                }
+            }
+        }
+    }
+
+    if (meet < 0) return false;
+    joinAt(ctx, meet, t);
+    return true;
+}
+
+bool bidirectionalDijkstra(SearchContext& ctx, SearchObserver* observer) {
+    return bidirectionalDijkstra(ctx, ctx.open, ctx.backOpen, observer);
+}
+
+bool bidirectionalAstar(SearchContext& ctx, SearchObserver* observer) {
+    return bidirectionalAstar(ctx, ctx.open, ctx.backOpen, observer);
+}
+
+#define INSTANTIATE_BIDIRECTIONAL(OpenList) \
+    template bool bidirectionalDijkstra<OpenList>(SearchContext&, OpenList&, OpenList&, SearchObserver*); \
+    template bool bidirectionalAstar<OpenList>(SearchContext&, OpenList&, OpenList&, SearchObserver*);
+
+INSTANTIATE_BIDIRECTIONAL(BinaryHeapOpenList)
+INSTANTIATE_BIDIRECTIONAL(BucketQueue)
+INSTANTIATE_BIDIRECTIONAL(RadixHeap)
+INSTANTIATE_BIDIRECTIONAL(QuaternaryHeap)
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Pathfinder.h"
+
+// Bidirectional solvers: one search grows from ctx.start over ctx.node records and one
+// from ctx.goal over ctx.backNode records, until the algorithm's stopping rule proves
+// the best meeting found so far is optimal. On success the forward parents are extended
+// through the meeting cell to the goal, so reconstructPath and node(goal).g read as for
+// the one-sided solvers. stats.expandedForward/expandedBackward split nodesExplored by side.
+
+// Level-synchronous BFS that always expands the smaller frontier; stops at the first meeting
+bool bidirectionalBfs(SearchContext& ctx, SearchObserver* observer = nullptr);
+
+// Alternates sides by smallest settled distance; stops once the two radii sum to the best path
+template <class OpenList>
+bool bidirectionalDijkstra(SearchContext& ctx, OpenList& forward, OpenList& backward, SearchObserver* observer = nullptr);
+bool bidirectionalDijkstra(SearchContext& ctx, SearchObserver* observer = nullptr);
+
+// NBA* (Pijls & Post): front-to-end A* from both sides with the Manhattan heuristic, where a
+// popped node is only expanded if neither side's bound shows it can't improve the best path
+template <class OpenList>
+bool bidirectionalAstar(SearchContext& ctx, OpenList& forward, OpenList& backward, SearchObserver* observer = nullptr);
+bool bidirectionalAstar(SearchContext& ctx, SearchObserver* observer = nullptr);
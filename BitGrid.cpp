@@ -0,0 +1,127 @@
+#include "BitGrid.h"
+#include "Bits.h"
+#include "JumpPoint.h"
+
+using namespace std;
+
+void BitGrid::build(const Grid& grid) {
+    stride_ = grid.stride();
+    height_ = grid.rows() + 2;
+    rowWords = (stride_ + 63) / 64 + 1;
+    colWords = (height_ + 63) / 64 + 1;
+    rowBits.assign(static_cast<size_t>(height_) * rowWords, 0);
+    colBits.assign(static_cast<size_t>(stride_) * colWords, 0);
+
+    for (int px = 1; px <= grid.rows(); ++px)
+        for (int py = 1; py <= grid.cols(); ++py)
+            if (grid.isValid(px * stride_ + py)) set(px * stride_ + py, true);
+}
+
+void BitGrid::set(int idx, bool open) {
+    int px = idx / stride_, py = idx % stride_;
+    uint64_t& r = rowBits[static_cast<size_t>(px) * rowWords + (py >> 6)];
+    uint64_t& c = colBits[static_cast<size_t>(py) * colWords + (px >> 6)];
+    if (open) {
+        r |= 1ULL << (py & 63);
+        c |= 1ULL << (px & 63);
+    }
+    else {
+        r &= ~(1ULL << (py & 63));
+        c &= ~(1ULL << (px & 63));
+    }
+}
+
+// Scans a lane from pos towards dir (+1 or -1), a word at a time. sideA and sideB are
+// the two parallel lanes beside it. A cell is a stop if it is a wall, the goal (goal is
+// its lane position, or -1 if the goal isn't on this lane) or has a forced neighbour:
+// a side cell one step ahead is open while the side cell level with it is blocked.
+// Returns the position of the first stop if it's an open cell, or -1 if it's a wall.
+static int scanLane(const uint64_t* lane, const uint64_t* sideA, const uint64_t* sideB,
+    int pos, int dir, int goal) {
+    if (!((lane[pos >> 6] >> (pos & 63)) & 1)) return -1; // Starts in a wall
+
+    int w = pos >> 6;
+    uint64_t mask = dir > 0 ? ~0ULL << (pos & 63) : ~0ULL >> (63 - (pos & 63));
+    for (;; w += dir, mask = ~0ULL) {
+        PROFILE_COUNT(jumpSteps);
+        uint64_t a = sideA[w], b = sideB[w];
+        uint64_t aAhead, bAhead;
+        if (dir > 0) {
+            aAhead = (a >> 1) | (sideA[w + 1] << 63);
+            bAhead = (b >> 1) | (sideB[w + 1] << 63);
+        }
+        else {
+            aAhead = (a << 1) | (w > 0 ? sideA[w - 1] >> 63 : 0);
+            bAhead = (b << 1) | (w > 0 ? sideB[w - 1] >> 63 : 0);
+        }
+        uint64_t stop = ~lane[w] | (aAhead & ~a) | (bAhead & ~b);
+        if (goal >= 0 && (goal >> 6) == w) stop |= 1ULL << (goal & 63);
+        stop &= mask;
+        if (stop) {
+            int p = (w << 6) + (dir > 0 ? lowestBit(stop) : highestBit(stop));
+            return ((lane[p >> 6] >> (p & 63)) & 1) ? p : -1;
+        }
+    }
+}
+
+// Cardinal scan along padded row px from column py; returns the stop column or -1
+static int scanRow(const BitGrid& bits, int px, int py, int dy, int gx, int gy) {
+    return scanLane(bits.row(px), bits.row(px - 1), bits.row(px + 1), py, dy, gx == px ? gy : -1);
+}
+
+// Cardinal scan along padded column py from row px; returns the stop row or -1
+static int scanColumn(const BitGrid& bits, int px, int py, int dx, int gx, int gy) {
+    return scanLane(bits.column(py), bits.column(py - 1), bits.column(py + 1), px, dx, gy == py ? gx : -1);
+}
+
+// Bit-parallel jump: the same jump points as the grid-scanning jump in Pathfinder.cpp
+struct BitJumper {
+    const BitGrid& bits;
+    bool operator()(int from, int dir, int end, int& out) const {
+        int stride = bits.stride();
+        int dx = dx_8[dir], dy = dy_8[dir];
+        int px = from / stride + dx, py = from % stride + dy;
+        int gx = end / stride, gy = end % stride;
+
+        if (dx == 0) {
+            int p = scanRow(bits, px, py, dy, gx, gy);
+            if (p < 0) return false;
+            out = px * stride + p;
+            return true;
+        }
+        if (dy == 0) {
+            int p = scanColumn(bits, px, py, dx, gx, gy);
+            if (p < 0) return false;
+            out = p * stride + py;
+            return true;
+        }
+
+        // Diagonal: step one cell at a time, probing both cardinal components with word scans
+        for (; bits.isOpen(px, py); px += dx, py += dy) {
+            PROFILE_COUNT(jumpSteps);
+            if ((px == gx && py == gy) ||
+                (bits.isOpen(px - dx, py + dy) && !bits.isOpen(px - dx, py)) ||
+                (bits.isOpen(px + dx, py - dy) && !bits.isOpen(px, py - dy)) ||
+                scanColumn(bits, px + dx, py, dx, gx, gy) >= 0 ||
+                scanRow(bits, px, py + dy, dy, gx, gy) >= 0) {
+                out = px * stride + py;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+template <class OpenList>
+bool jpsBits(SearchContext& ctx, const BitGrid& bits, OpenList& open, SearchObserver* observer) {
+    return jumpPointSearch(ctx, open, BitJumper{ bits }, observer);
+}
+
+bool jpsBits(SearchContext& ctx, const BitGrid& bits, SearchObserver* observer) {
+    return jpsBits(ctx, bits, ctx.open, observer);
+}
+
+template bool jpsBits<BinaryHeapOpenList>(SearchContext&, const BitGrid&, BinaryHeapOpenList&, SearchObserver*);
+template bool jpsBits<BucketQueue>(SearchContext&, const BitGrid&, BucketQueue&, SearchObserver*);
+template bool jpsBits<RadixHeap>(SearchContext&, const BitGrid&, RadixHeap&, SearchObserver*);
+template bool jpsBits<QuaternaryHeap>(SearchContext&, const BitGrid&, QuaternaryHeap&, SearchObserver*);
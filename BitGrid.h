@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Pathfinder.h"
+
+// Bit-packed copy of a Grid's walls for word-parallel scanning. Every padded row and
+// every padded column is stored as its own run of 64-bit words (bit set = open), so a
+// scan along either axis tests 64 cells per word. Lanes use padded coordinates
+// (px = x + 1, py = y + 1) and end with one spare zero word, so a scan may always read
+// the word after the one it is in.
+class BitGrid {
+public:
+    BitGrid() {}
+    explicit BitGrid(const Grid& grid) { build(grid); }
+
+    // Rebuilds both bit layers from the grid's walls
+    void build(const Grid& grid);
+    // Updates one cell, given by its flat Grid index, after the grid was edited
+    void set(int idx, bool open);
+
+    int stride() const { return stride_; }
+    bool isOpen(int px, int py) const { return (rowBits[px * rowWords + (py >> 6)] >> (py & 63)) & 1; }
+
+    // Open bits of padded row px (indexed by py) and of padded column py (indexed by px)
+    const std::uint64_t* row(int px) const { return &rowBits[static_cast<size_t>(px) * rowWords]; }
+    const std::uint64_t* column(int py) const { return &colBits[static_cast<size_t>(py) * colWords]; }
+
+    // Bytes used by both bit layers
+    size_t memoryBytes() const { return (rowBits.size() + colBits.size()) * sizeof(std::uint64_t); }
+
+private:
+    int stride_ = 0;   // Padded columns, as in Grid
+    int height_ = 0;   // Padded rows
+    int rowWords = 0;  // Words per row lane, including the spare
+    int colWords = 0;  // Words per column lane, including the spare
+    std::vector<std::uint64_t> rowBits;
+    std::vector<std::uint64_t> colBits;
+};
+
+// Jump Point Search that finds jump points with word-level scans over a BitGrid built
+// from ctx.grid. Returns the same paths, costs and node counts as jps.
+template <class OpenList>
+bool jpsBits(SearchContext& ctx, const BitGrid& bits, OpenList& open, SearchObserver* observer = nullptr);
+bool jpsBits(SearchContext& ctx, const BitGrid& bits, SearchObserver* observer = nullptr);
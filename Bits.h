@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+// Portable bit-scan helpers. Arguments must be non-zero.
+
+// Index of the lowest set bit
+inline int lowestBit(std::uint64_t v) {
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward64(&i, v);
+    return static_cast<int>(i);
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+// Index of the highest set bit
+inline int highestBit(std::uint64_t v) {
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanReverse64(&i, v);
+    return static_cast<int>(i);
+#else
+    return 63 - __builtin_clzll(v);
+#endif
+}
+
+// Hints that p will be read soon; a no-op where the compiler has no prefetch intrinsic
+inline void prefetch(const void* p) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#elif defined(__GNUC__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+}
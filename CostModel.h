@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Pathfinder.h"
+
+// Movement cost models for the best-first solvers (BFS, Dijkstra, A*; see BestFirst.h).
+//
+// Every model has the same interface:
+//   DIRS, DX[], DY[]                   compile-time move directions (from Moves4 or Moves8)
+//   canMove(grid, offsets, from, dir)  extra rule for a move whose target is already known
+//                                      open; offsets[i] is the flat offset of direction i
+//   step(to, dir)                      cost of moving in direction dir onto cell `to`
+//   heuristic(a, b)                    lower bound on the cost from a to b, consistent with step
+//
+// The solvers are templated on the model, so each instantiation unrolls its move loop and
+// inlines its rules into the relaxation. Weighted models use the fixed-point units
+// COST_ONE/COST_DIAGONAL from Pathfinder.h; g values then fit an int for paths up to
+// ~2 million unit steps.
+
+// Per-cell traversal weights: entering a cell of weight w costs w times the base step.
+// Stored over the grid's padded flat indices; walls and the border keep weight 1.
+class TerrainMap {
+public:
+    // Sizes the map for grid with every cell at weight 1
+    void build(const Grid& grid) {
+        rows_ = grid.rows();
+        cols_ = grid.cols();
+        weights.assign(grid.size(), 1);
+        stride = grid.stride();
+        minWeight_ = 1;
+    }
+    // weight must be at least 1
+    void set(int x, int y, std::uint8_t weight) {
+        weights[static_cast<size_t>(x + 1) * stride + (y + 1)] = weight;
+        if (weight < minWeight_) minWeight_ = weight;
+    }
+
+    int weight(int idx) const { return weights[idx]; }
+    // Lower bound on every weight (set() only ever lowers it); scales the heuristics
+    int minWeight() const { return minWeight_; }
+    bool matches(const Grid& grid) const { return rows_ == grid.rows() && cols_ == grid.cols(); }
+    size_t memoryBytes() const { return weights.size(); }
+
+private:
+    int rows_ = 0, cols_ = 0, stride = 2;
+    int minWeight_ = 1;
+    std::vector<std::uint8_t> weights;
+};
+
+// Compile-time move tables, in the order of dx_4/dy_4 and dx_8/dy_8
+struct Moves4 {
+    static constexpr int DIRS = DIRS_4;
+    static constexpr int DX[DIRS_4] = { -1, 1, 0, 0 };
+    static constexpr int DY[DIRS_4] = { 0, 0, -1, 1 };
+};
+
+struct Moves8 {
+    static constexpr int DIRS = DIRS_8;
+    static constexpr int DX[DIRS_8] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+    static constexpr int DY[DIRS_8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+};
+
+// Unit-cost 4-connected moves, the model of every solver that takes no cost argument.
+// Everything is constexpr, so an instantiation with it compiles to the plain cost-1 loop.
+struct UniformCost : Moves4 {
+    static constexpr bool canMove(const Grid&, const int*, int, int) { return true; }
+    static constexpr int step(int, int) { return 1; }
+    static int heuristic(Point a, Point b) { return heuristic_manhattan(a, b); }
+};
+
+// 4-connected moves priced by the weight of the cell entered, in COST_ONE units
+struct TerrainCost : Moves4 {
+    explicit TerrainCost(const TerrainMap& terrain) : terrain(&terrain) {}
+
+    static constexpr bool canMove(const Grid&, const int*, int, int) { return true; }
+    int step(int to, int) const { return COST_ONE * terrain->weight(to); }
+    int heuristic(Point a, Point b) const { return COST_ONE * terrain->minWeight() * heuristic_manhattan(a, b); }
+
+    const TerrainMap* terrain;
+};
+
+// Which diagonal moves OctileCost allows, by the two cells beside the diagonal
+enum class CornerRule {
+    Cut,       // Always, even between two walls (the rule the jps variants assume)
+    NoSqueeze, // Unless both side cells are walls
+    NoCut      // Only if both side cells are open (the MovingAI benchmark rule)
+};
+
+// 8-connected moves: straight steps cost COST_ONE and diagonal ones COST_DIAGONAL, times
+// the weight of the cell entered when a TerrainMap is given. Directions follow dx_8/dy_8,
+// where the odd ones are diagonal.
+struct OctileCost : Moves8 {
+    explicit OctileCost(CornerRule corners = CornerRule::NoCut, const TerrainMap* terrain = nullptr)
+        : corners(corners), terrain(terrain) {}
+
+    bool canMove(const Grid& grid, const int* offsets, int from, int dir) const {
+        if (!(dir & 1) || corners == CornerRule::Cut) return true;
+        bool left = grid.isValid(from + offsets[dir - 1]);
+        bool right = grid.isValid(from + offsets[(dir + 1) & 7]);
+        return corners == CornerRule::NoCut ? left && right : left || right;
+    }
+    int step(int to, int dir) const {
+        int base = dir & 1 ? COST_DIAGONAL : COST_ONE;
+        return terrain ? base * terrain->weight(to) : base;
+    }
+    int heuristic(Point a, Point b) const {
+        int h = heuristic_octile(a, b);
+        return terrain ? h * terrain->minWeight() : h;
+    }
+
+    CornerRule corners;
+    const TerrainMap* terrain;
+};
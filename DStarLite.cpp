@@ -0,0 +1,150 @@
+#include "DStarLite.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+int DStarLite::heuristic(int cell) const {
+    return heuristic_manhattan(grid.point(s), grid.point(cell));
+}
+
+// [min(g, rhs) + h + km, min(g, rhs)] packed into one integer that compares lexicographically
+int64_t DStarLite::key(int cell) const {
+    int m = min(g[cell], rhs[cell]);
+    return (static_cast<int64_t>(m + heuristic(cell) + km) << 32) | m;
+}
+
+// Recomputes rhs from the successors and queues the cell if it became inconsistent
+void DStarLite::updateVertex(int cell) {
+    if (cell != t) {
+        int best = INF;
+        if (grid.isValid(cell)) {
+            for (int i = 0; i < DIRS_4; ++i) {
+                int next = cell + grid.offset4[i];
+                if (grid.isValid(next)) best = min(best, g[next] + 1);
+            }
+        }
+        rhs[cell] = best;
+    }
+    if (g[cell] != rhs[cell]) {
+        open.push({ key(cell), cell });
+        stats.pushes++;
+    }
+}
+
+bool DStarLite::computeShortestPath(SearchObserver* observer) {
+    while (!open.empty() && (open.top().first < key(s) || rhs[s] != g[s])) {
+        Entry top = open.top();
+        open.pop();
+        stats.pops++;
+        int u = top.second;
+        if (g[u] == rhs[u]) continue; // Consistent again since this entry was queued
+        int64_t current = key(u);
+        if (top.first < current) { // Key grew since it was queued (start moved): requeue
+            open.push({ current, u });
+            stats.pushes++;
+            continue;
+        }
+        if (top.first > current) continue; // A fresher entry with the current key exists
+
+        stats.nodesExplored++;
+        if (observer) observer->onExpand(grid.point(u));
+        if (g[u] > rhs[u]) {
+            g[u] = rhs[u];
+        }
+        else {
+            g[u] = INF;
+            updateVertex(u);
+        }
+        for (int i = 0; i < DIRS_4; ++i) {
+            int pred = u + grid.offset4[i];
+            if (!grid.isValid(pred)) continue;
+            int before = rhs[pred];
+            updateVertex(pred);
+            if (observer && rhs[pred] != before) observer->onVisit(grid.point(pred));
+        }
+    }
+    return rhs[s] < INF;
+}
+
+bool DStarLite::plan(Point start, Point goal, SearchObserver* observer) {
+    stats = SearchStats();
+    s = last = grid.index(start.x, start.y);
+    t = grid.index(goal.x, goal.y);
+    km = 0;
+    g.assign(grid.size(), INF);
+    rhs.assign(grid.size(), INF);
+    open = decltype(open)();
+
+    if (grid.isValid(t)) {
+        rhs[t] = 0;
+        open.push({ key(t), t });
+        stats.pushes++;
+    }
+    return computeShortestPath(observer);
+}
+
+void DStarLite::moveStart(Point start) {
+    s = grid.index(start.x, start.y);
+}
+
+void DStarLite::applyEdits(const vector<CellEdit>& edits) {
+    // Keys stored so far used the old start; km keeps them lower bounds
+    km += heuristic_manhattan(grid.point(last), grid.point(s));
+    last = s;
+
+    for (const CellEdit& e : edits) {
+        // Cells outside the map would overwrite the WALL border isValid relies on
+        if (!grid.inBounds(e.cell.x, e.cell.y)) continue;
+        int cell = grid.index(e.cell.x, e.cell.y);
+        if (e.wall && (cell == s || cell == t)) continue;
+        char& c = grid[cell];
+        if (e.wall == (c == WALL)) continue;
+        c = e.wall ? WALL : PATH;
+
+        // Every edge into or out of the cell changed cost. Nothing reads a wall's g, so a
+        // new wall is settled at once rather than queued.
+        if (e.wall) g[cell] = INF;
+        updateVertex(cell);
+        for (int i = 0; i < DIRS_4; ++i) {
+            int next = cell + grid.offset4[i];
+            if (grid.isValid(next)) updateVertex(next);
+        }
+    }
+    grid.markEdited();
+}
+
+bool DStarLite::replan(SearchObserver* observer) {
+    stats = SearchStats();
+    if (s != last) {
+        km += heuristic_manhattan(grid.point(last), grid.point(s));
+        last = s;
+    }
+    return computeShortestPath(observer);
+}
+
+int DStarLite::pathCost() const {
+    return rhs[s] < INF ? rhs[s] : -1;
+}
+
+vector<Point> DStarLite::path() const {
+    vector<Point> cells;
+    if (rhs[s] >= INF) return cells;
+    int curr = s;
+    cells.push_back(grid.point(curr));
+    while (curr != t) {
+        int best = -1, bestG = INF;
+        for (int i = 0; i < DIRS_4; ++i) {
+            int next = curr + grid.offset4[i];
+            if (grid.isValid(next) && g[next] < bestG) {
+                bestG = g[next];
+                best = next;
+            }
+        }
+        if (best < 0 || static_cast<int>(cells.size()) > grid.size()) return vector<Point>();
+        curr = best;
+        cells.push_back(grid.point(curr));
+    }
+    return cells;
+}
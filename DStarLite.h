@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+#include "Pathfinder.h"
+
+// One cell flip for DStarLite::applyEdits
+struct CellEdit {
+    Point cell;
+    bool wall; // true to turn the cell into WALL, false to open it (PATH)
+};
+
+// Incremental planner for maps whose walls change (D* Lite, Koenig & Likhachev). The
+// search runs from the goal towards the start and keeps its g/rhs values between calls,
+// so after a batch of edits replan() only re-expands the cells whose distance to the goal
+// changed, instead of searching from scratch. The start may move between replans, as an
+// agent walking the path would. Holds a reference to the grid it plans on and edits it.
+class DStarLite {
+public:
+    explicit DStarLite(Grid& grid) : grid(grid) {}
+
+    // Plans from scratch; returns true if the goal is reachable from start
+    bool plan(Point start, Point goal, SearchObserver* observer = nullptr);
+    // Moves the start (e.g. to the agent's next cell); takes effect on the next replan
+    void moveStart(Point start);
+    // Writes the edits into the grid and marks the cells around them for repair.
+    // START and END cells are never turned into walls, and edits outside the grid are skipped.
+    void applyEdits(const std::vector<CellEdit>& edits);
+    // Repairs the plan after applyEdits/moveStart; returns true if a path still exists
+    bool replan(SearchObserver* observer = nullptr);
+
+    // Start-to-goal path (both included) by following the cheapest neighbour; empty if none
+    std::vector<Point> path() const;
+    // Length in steps of the current plan, or -1 if the goal is unreachable
+    int pathCost() const;
+
+    // Counters of the last plan() or replan()
+    SearchStats stats;
+
+private:
+    typedef std::pair<std::int64_t, int> Entry; // (packed key, cell)
+
+    std::int64_t key(int cell) const;
+    void updateVertex(int cell);
+    bool computeShortestPath(SearchObserver* observer);
+    int heuristic(int cell) const;
+
+    static constexpr int INF = 0x3fffffff;
+
+    Grid& grid;
+    int s = 0, t = 0;   // Start and goal cells
+    int last = 0;       // Start when the key modifier was last updated
+    int km = 0;         // Key modifier: heuristic drift from start moves
+    std::vector<int> g, rhs;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open; // Lazy deletion
+};
@@ -0,0 +1,107 @@
+#include "DistanceTable.h"
+#include "Parallel.h"
+
+#include <algorithm>
+
+using namespace std;
+
+template <class Cost>
+DistanceTable<Cost>::DistanceTable(const Grid& grid, const Cost& cost, int threads) : grid(grid), cost(cost) {
+    workers.assign(threads > 0 ? threads : defaultThreadCount(), Worker(grid));
+}
+
+template <class Cost>
+long long DistanceTable<Cost>::nodesSettled() const {
+    long long total = 0;
+    for (const Worker& w : workers) total += w.settled;
+    return total;
+}
+
+template <class Cost>
+vector<int> DistanceTable<Cost>::flatTargets(const vector<Point>& targets) const {
+    vector<int> cells;
+    cells.reserve(targets.size());
+    for (const Point& p : targets) cells.push_back(grid.index(p.x, p.y));
+    return cells;
+}
+
+// One sweep from source that stops once every open target cell is settled. Repeated
+// targets share the slot of their first occurrence and are copied at the end.
+template <class Cost>
+void DistanceTable<Cost>::sweep(Worker& w, int source, const vector<int>& targets, int* out) {
+    int remaining = 0;
+    for (size_t j = 0; j < targets.size(); ++j) {
+        out[j] = -1;
+        if (grid.isValid(targets[j]) && w.slot[targets[j]] < 0) {
+            w.slot[targets[j]] = static_cast<int>(j);
+            remaining++;
+        }
+    }
+
+    SearchContext& ctx = w.ctx;
+    ctx.reset();
+    int offsets[Cost::DIRS];
+    for (int i = 0; i < Cost::DIRS; ++i) offsets[i] = Cost::DX[i] * grid.stride() + Cost::DY[i];
+    w.open.clear(grid.size());
+    if (grid.isValid(source)) {
+        ctx.node(source).g = 0;
+        ctx.node(source).parent = source;
+        w.open.push(0, source);
+    }
+
+    while (remaining > 0 && !w.open.empty()) {
+        int curr = w.open.pop();
+        NodeState& c = ctx.node(curr);
+        if (c.visited) {
+            PROFILE_COUNT(stalePops);
+            continue;
+        }
+        c.visited = true;
+        w.settled++;
+        if (w.slot[curr] >= 0) {
+            out[w.slot[curr]] = c.g;
+            remaining--;
+        }
+
+        for (int i = 0; i < Cost::DIRS; ++i) {
+            int next = curr + offsets[i];
+            if (!grid.isValid(next) || !cost.canMove(grid, offsets, curr, i)) continue;
+            NodeState& n = ctx.node(next);
+            int g = c.g + cost.step(next, i);
+            if (g < n.g) {
+                n.g = g;
+                n.parent = curr;
+                w.open.push(g, next);
+            }
+        }
+    }
+
+    for (size_t j = 0; j < targets.size(); ++j) {
+        if (!grid.isValid(targets[j])) continue;
+        int first = w.slot[targets[j]];
+        if (first != static_cast<int>(j)) out[j] = out[first];
+    }
+    for (int t : targets) w.slot[t] = -1;
+}
+
+template <class Cost>
+void DistanceTable<Cost>::oneToMany(Point source, const vector<Point>& targets, vector<int>& distances) {
+    workers[0].settled = 0;
+    distances.resize(targets.size());
+    sweep(workers[0], grid.index(source.x, source.y), flatTargets(targets), distances.data());
+}
+
+template <class Cost>
+void DistanceTable<Cost>::manyToMany(const vector<Point>& sources, const vector<Point>& targets, vector<int>& table) {
+    for (Worker& w : workers) w.settled = 0;
+    vector<int> cells = flatTargets(targets);
+    table.resize(sources.size() * targets.size());
+    int count = static_cast<int>(sources.size());
+    parallelFor(count, min(threads(), max(1, count)), [&](int i, int worker) {
+        sweep(workers[worker], grid.index(sources[i].x, sources[i].y), cells, table.data() + static_cast<size_t>(i) * targets.size());
+    });
+}
+
+template class DistanceTable<UniformCost>;
+template class DistanceTable<TerrainCost>;
+template class DistanceTable<OctileCost>;
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <type_traits>
+#include <vector>
+#include "Pathfinder.h"
+#include "CostModel.h"
+
+// One-to-many and many-to-many shortest-path distances on a grid, for dispatching N
+// agents to M targets. Each source costs one sweep that stops as soon as every target is
+// settled, instead of one search per (source, target) pair: BFS under UniformCost and
+// Dijkstra (with a BucketQueue) under the weighted models. Sources are spread over
+// worker threads, each with its own search state; the grid is only read.
+//
+// Distances are in the cost model's units (steps for UniformCost), -1 when unreachable.
+// Instantiated for UniformCost, TerrainCost and OctileCost.
+template <class Cost = UniformCost>
+class DistanceTable {
+public:
+    // threads <= 0 means defaultThreadCount()
+    explicit DistanceTable(const Grid& grid, const Cost& cost = Cost(), int threads = 0);
+
+    // distances[j] from source to targets[j]; runs on the calling thread
+    void oneToMany(Point source, const std::vector<Point>& targets, std::vector<int>& distances);
+    // table[i * targets.size() + j] from sources[i] to targets[j]
+    void manyToMany(const std::vector<Point>& sources, const std::vector<Point>& targets, std::vector<int>& table);
+
+    int threads() const { return static_cast<int>(workers.size()); }
+    // Cells settled by the last call, summed over all sweeps
+    long long nodesSettled() const;
+
+private:
+    typedef typename std::conditional<std::is_same<Cost, UniformCost>::value, FifoQueue, BucketQueue>::type OpenList;
+
+    // Search state of one thread, on its own cache lines
+    struct alignas(64) Worker {
+        explicit Worker(const Grid& grid) : ctx(grid), slot(grid.size(), -1) {}
+        SearchContext ctx;
+        OpenList open;
+        std::vector<int> slot; // Index into the sweep's target list for target cells, else -1
+        long long settled = 0;
+    };
+
+    void sweep(Worker& w, int source, const std::vector<int>& targets, int* out);
+    std::vector<int> flatTargets(const std::vector<Point>& targets) const;
+
+    const Grid& grid;
+    Cost cost;
+    std::vector<Worker> workers;
+};
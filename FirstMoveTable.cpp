@@ -0,0 +1,275 @@
+#include "FirstMoveTable.h"
+#include "Bits.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <fstream>
+
+using namespace std;
+
+// Every direction accepted: the first move towards a cell the source can't reach
+static const uint8_t ANY_MOVE = 0xff;
+
+// Numbers the open cells in depth-first preorder under the model's moves, one connected
+// component after the other, so every component is a contiguous range of numbers
+template <class Cost>
+void FirstMoveTable<Cost>::number(const Grid& grid) {
+    rows_ = grid.rows();
+    cols_ = grid.cols();
+    rank.assign(grid.size(), -1);
+    cells.clear();
+    componentStarts.clear();
+    int moveOffsets[Cost::DIRS];
+    for (int i = 0; i < Cost::DIRS; ++i) moveOffsets[i] = Cost::DX[i] * grid.stride() + Cost::DY[i];
+
+    vector<StackFrame> stack;
+    for (int x = 0; x < rows_; ++x) {
+        for (int y = 0; y < cols_; ++y) {
+            int root = grid.index(x, y);
+            if (!grid.isValid(root) || rank[root] >= 0) continue;
+            componentStarts.push_back(static_cast<int32_t>(cells.size()));
+            rank[root] = static_cast<int32_t>(cells.size());
+            cells.push_back(root);
+            stack.push_back(StackFrame{ root, 0 });
+            while (!stack.empty()) {
+                StackFrame& top = stack.back();
+                if (top.dir == Cost::DIRS) {
+                    stack.pop_back();
+                    continue;
+                }
+                int from = top.cell, dir = top.dir++;
+                int next = from + moveOffsets[dir];
+                if (!grid.isValid(next) || rank[next] >= 0 || !cost_.canMove(grid, moveOffsets, from, dir)) continue;
+                rank[next] = static_cast<int32_t>(cells.size());
+                cells.push_back(next);
+                stack.push_back(StackFrame{ next, 0 });
+            }
+        }
+    }
+}
+
+// Full sweep from the source with number `source`, keeping for every settled cell the
+// set of first moves that start one of its shortest paths, then the greedy run-length
+// encoding of those sets in target order: a run grows while some move is common to all
+// of its targets. Only the source's own component needs encoding; the unreachable
+// targets around it accept any move, so they join the first and last runs.
+template <class Cost>
+void FirstMoveTable<Cost>::sweep(const Grid& grid, Worker& w, int source, vector<uint32_t>& out) const {
+    int moveOffsets[Cost::DIRS];
+    for (int i = 0; i < Cost::DIRS; ++i) moveOffsets[i] = Cost::DX[i] * grid.stride() + Cost::DY[i];
+    int s = cells[source];
+    SearchContext& ctx = w.ctx;
+    ctx.reset();
+    w.open.clear(grid.size());
+    ctx.node(s).g = 0;
+    ctx.node(s).parent = s;
+    w.open.push(0, s);
+
+    while (!w.open.empty()) {
+        int curr = w.open.pop();
+        NodeState& c = ctx.node(curr);
+        if (c.visited) {
+            PROFILE_COUNT(stalePops);
+            continue;
+        }
+        c.visited = true;
+
+        // A settled cell's set is final (steps cost > 0, so its shortest-path predecessors
+        // were all settled before it): a shorter path through it replaces the neighbour's
+        // set, an equally short one adds to it
+        for (int i = 0; i < Cost::DIRS; ++i) {
+            int next = curr + moveOffsets[i];
+            if (!grid.isValid(next) || !cost_.canMove(grid, moveOffsets, curr, i)) continue;
+            NodeState& n = ctx.node(next);
+            int g = c.g + cost_.step(next, i);
+            uint8_t moves = curr == s ? static_cast<uint8_t>(1u << i) : w.moves[curr];
+            if (g < n.g) {
+                n.g = g;
+                n.parent = curr;
+                w.moves[next] = moves;
+                w.open.push(g, next);
+            }
+            else if (g == n.g) {
+                w.moves[next] |= moves;
+            }
+        }
+    }
+
+    size_t component = upper_bound(componentStarts.begin(), componentStarts.end(), source) - componentStarts.begin() - 1;
+    int first = componentStarts[component];
+    int last = component + 1 < componentStarts.size() ? componentStarts[component + 1] : openCells();
+    out.clear();
+    uint32_t runStart = 0;
+    uint8_t common = ANY_MOVE;
+    for (int target = first; target < last; ++target) {
+        if (target == source) continue;
+        uint8_t moves = ctx.touched(cells[target]) ? w.moves[cells[target]] : ANY_MOVE;
+        if (common & moves) {
+            common &= moves;
+            continue;
+        }
+        out.push_back(runStart << 3 | static_cast<uint32_t>(lowestBit(common)));
+        runStart = static_cast<uint32_t>(target);
+        common = moves;
+    }
+    out.push_back(runStart << 3 | static_cast<uint32_t>(lowestBit(common)));
+}
+
+template <class Cost>
+void FirstMoveTable<Cost>::build(const Grid& grid, int threads) {
+    number(grid);
+    int sources = openCells();
+    vector<vector<uint32_t>> perSource(sources);
+    int count = min(threads > 0 ? threads : defaultThreadCount(), max(1, sources));
+    vector<Worker> workers(count, Worker(grid));
+    parallelFor(sources, count, [&](int source, int worker) {
+        sweep(grid, workers[worker], source, perSource[source]);
+    });
+
+    offsets.assign(static_cast<size_t>(sources) + 1, 0);
+    for (int r = 0; r < sources; ++r) offsets[r + 1] = offsets[r] + perSource[r].size();
+    runs.resize(offsets[sources]);
+    for (int r = 0; r < sources; ++r) {
+        copy(perSource[r].begin(), perSource[r].end(), runs.begin() + offsets[r]);
+        vector<uint32_t>().swap(perSource[r]);
+    }
+}
+
+template <class Cost>
+int FirstMoveTable<Cost>::firstMove(int from, int to) const {
+    if (rank.empty()) return -1;
+    int source = rank[from], target = rank[to];
+    if (source < 0 || target < 0 || source == target) return -1;
+    // Same component: both lie before the first component start after the source
+    auto next = upper_bound(componentStarts.begin(), componentStarts.end(), source);
+    if (target < *(next - 1) || (next != componentStarts.end() && target >= *next)) return -1;
+
+    const uint32_t* begin = runs.data() + offsets[source];
+    const uint32_t* end = runs.data() + offsets[source + 1];
+    const uint32_t* run = upper_bound(begin, end, static_cast<uint32_t>(target) << 3 | 7) - 1;
+    PROFILE_COUNT(firstMoveLookups);
+    return static_cast<int>(*run & 7);
+}
+
+// File layout: "PCPD", format version, rows, cols, move directions, open cells, then the
+// run count, the per-source offsets and the runs. The numbering is rebuilt from the grid.
+static const char TABLE_MAGIC[4] = { 'P', 'C', 'P', 'D' };
+static const int32_t TABLE_VERSION = 1;
+
+template <class Cost>
+bool FirstMoveTable<Cost>::save(const string& path) const {
+    ofstream out(path, ios::binary);
+    if (!out) return false;
+    int32_t header[5] = { TABLE_VERSION, rows_, cols_, Cost::DIRS, openCells() };
+    uint64_t runCount = runs.size();
+    out.write(TABLE_MAGIC, sizeof(TABLE_MAGIC));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(&runCount), sizeof(runCount));
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(runs.data()), runs.size() * sizeof(uint32_t));
+    return static_cast<bool>(out);
+}
+
+template <class Cost>
+bool FirstMoveTable<Cost>::load(const string& path, const Grid& grid) {
+    clear();
+    ifstream in(path, ios::binary | ios::ate);
+    uint64_t fileBytes = in ? static_cast<uint64_t>(in.tellg()) : 0;
+    in.seekg(0);
+    char magic[4];
+    int32_t header[5];
+    uint64_t runCount;
+    if (!in.read(magic, sizeof(magic)) || !in.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        !in.read(reinterpret_cast<char*>(&runCount), sizeof(runCount)))
+        return false;
+    if (!equal(magic, magic + 4, TABLE_MAGIC) || header[0] != TABLE_VERSION || header[1] != grid.rows() ||
+        header[2] != grid.cols() || header[3] != Cost::DIRS)
+        return false;
+
+    number(grid);
+    // The offsets and runs must fill the rest of the file exactly, which also bounds
+    // runCount before anything is sized by it
+    uint64_t offsetBytes = (static_cast<uint64_t>(openCells()) + 1) * sizeof(uint64_t);
+    uint64_t headerBytes = sizeof(magic) + sizeof(header) + sizeof(runCount);
+    if (header[4] != openCells() || fileBytes < headerBytes + offsetBytes ||
+        runCount != (fileBytes - headerBytes - offsetBytes) / sizeof(uint32_t) ||
+        (fileBytes - headerBytes - offsetBytes) % sizeof(uint32_t) != 0) {
+        clear();
+        return false;
+    }
+    offsets.resize(static_cast<size_t>(openCells()) + 1);
+    runs.resize(runCount);
+    if (!in.read(reinterpret_cast<char*>(offsets.data()), offsetBytes) ||
+        !in.read(reinterpret_cast<char*>(runs.data()), runCount * sizeof(uint32_t)) || !validRuns()) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+// Checks what firstMove relies on: every source has at least one run, the first starting
+// at target 0, run starts increase and stay below openCells(), and every direction is
+// one of the model's
+template <class Cost>
+bool FirstMoveTable<Cost>::validRuns() const {
+    if (offsets.empty() || offsets[0] != 0 || offsets.back() != runs.size()) return false;
+    for (size_t r = 0; r + 1 < offsets.size(); ++r) {
+        if (offsets[r + 1] <= offsets[r] || offsets[r + 1] > runs.size() || runs[offsets[r]] >> 3 != 0) return false;
+        for (uint64_t i = offsets[r]; i < offsets[r + 1]; ++i) {
+            if ((runs[i] & 7) >= static_cast<uint32_t>(Cost::DIRS) || (runs[i] >> 3) >= static_cast<uint32_t>(openCells()))
+                return false;
+            if (i > offsets[r] && runs[i] >> 3 <= runs[i - 1] >> 3) return false;
+        }
+    }
+    return true;
+}
+
+template <class Cost>
+void FirstMoveTable<Cost>::clear() {
+    rows_ = cols_ = 0;
+    rank.clear();
+    cells.clear();
+    componentStarts.clear();
+    offsets.clear();
+    runs.clear();
+}
+
+template <class Cost>
+bool firstMovePath(SearchContext& ctx, const FirstMoveTable<Cost>& table, SearchObserver* observer) {
+    ctx.reset();
+    const Grid& grid = *ctx.grid;
+    int moveOffsets[Cost::DIRS];
+    for (int i = 0; i < Cost::DIRS; ++i) moveOffsets[i] = Cost::DX[i] * grid.stride() + Cost::DY[i];
+    int curr = grid.index(ctx.start.x, ctx.start.y);
+    int t = grid.index(ctx.goal.x, ctx.goal.y);
+    if (!grid.isValid(curr) || !grid.isValid(t)) return false;
+    NodeState& first = ctx.node(curr);
+    first.g = 0;
+    first.parent = curr;
+    first.visited = true;
+    ctx.stats.nodesExplored++;
+
+    while (curr != t) {
+        int dir = table.firstMove(curr, t);
+        if (dir < 0) return false;
+        int next = curr + moveOffsets[dir];
+        NodeState& n = ctx.node(next);
+        n.g = ctx.nodes[curr].g + table.cost().step(next, dir);
+        n.parent = curr;
+        n.visited = true;
+        ctx.stats.nodesExplored++;
+        if (observer) {
+            observer->onVisit(grid.point(next));
+            observer->onExpand(grid.point(next));
+        }
+        curr = next;
+    }
+    return true;
+}
+
+template class FirstMoveTable<UniformCost>;
+template class FirstMoveTable<TerrainCost>;
+template class FirstMoveTable<OctileCost>;
+template bool firstMovePath<UniformCost>(SearchContext&, const FirstMoveTable<UniformCost>&, SearchObserver*);
+template bool firstMovePath<TerrainCost>(SearchContext&, const FirstMoveTable<TerrainCost>&, SearchObserver*);
+template bool firstMovePath<OctileCost>(SearchContext&, const FirstMoveTable<OctileCost>&, SearchObserver*);
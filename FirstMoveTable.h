@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Pathfinder.h"
+#include "CostModel.h"
+
+// Compressed path database (CPD) for a static grid: for every open source cell, the first
+// move of a shortest path towards every target, run-length encoded. Queries then need no
+// search at all: firstMovePath steps from the start by table lookups, one binary search
+// over the current cell's runs per step, so a query costs O(path length * log runs).
+//
+// Targets are numbered in depth-first order over the open cells, which keeps nearby cells
+// (and whole connected components) contiguous so their first moves form long runs. Where
+// several first moves are optimal the build keeps all of them and picks, run by run, the
+// one that extends the current run furthest; targets the source cannot reach accept any
+// move. Building costs one full sweep per source (BFS under UniformCost, Dijkstra with a
+// BucketQueue otherwise), spread over worker threads: O(cells^2) time, so it is an
+// offline step for maps up to a few hundred thousand open cells, stored with save().
+//
+// Costs follow the model the table was built with, e.g. OctileCost(CornerRule::Cut) for
+// the moves and costs of jps. Instantiated for UniformCost, TerrainCost and OctileCost.
+template <class Cost = UniformCost>
+class FirstMoveTable {
+public:
+    explicit FirstMoveTable(const Cost& cost = Cost()) : cost_(cost) {}
+
+    // Builds the table for grid; threads <= 0 means defaultThreadCount()
+    void build(const Grid& grid, int threads = 0);
+
+    // Stores the table next to its map (e.g. "maze.cpd"). Both return false on I/O errors;
+    // load also fails if the file was built for a grid of different dimensions, open cell
+    // count or move set, or if its runs are inconsistent, and then leaves the table empty.
+    // The cost model itself isn't stored: load with the one used to build.
+    bool save(const std::string& path) const;
+    bool load(const std::string& path, const Grid& grid);
+
+    // Direction (index into Cost::DX/DY) of the first move from flat index `from` towards
+    // `to`; -1 if either is a wall, they are the same cell, `to` is unreachable or the
+    // table is empty
+    int firstMove(int from, int to) const;
+
+    const Cost& cost() const { return cost_; }
+    bool matches(const Grid& grid) const { return rows_ == grid.rows() && cols_ == grid.cols(); }
+    int openCells() const { return static_cast<int>(cells.size()); }
+    size_t runCount() const { return runs.size(); }
+    // Memory of the runs, their per-source offsets and the cell numbering
+    size_t memoryBytes() const {
+        return runs.size() * sizeof(std::uint32_t) + offsets.size() * sizeof(std::uint64_t) +
+            (rank.size() + cells.size() + componentStarts.size()) * sizeof(std::int32_t);
+    }
+
+private:
+    typedef typename std::conditional<std::is_same<Cost, UniformCost>::value, FifoQueue, BucketQueue>::type OpenList;
+
+    // Search state of one build thread, on its own cache lines
+    struct alignas(64) Worker {
+        explicit Worker(const Grid& grid) : ctx(grid), moves(grid.size(), 0) {}
+        SearchContext ctx;
+        OpenList open;
+        std::vector<std::uint8_t> moves; // Bit set of optimal first moves per settled cell
+    };
+
+    void number(const Grid& grid);
+    bool validRuns() const;
+    void clear();
+    void sweep(const Grid& grid, Worker& w, int source, std::vector<std::uint32_t>& out) const;
+
+    Cost cost_;
+    int rows_ = 0, cols_ = 0;
+    std::vector<std::int32_t> rank;            // Target number per padded flat index, -1 for walls
+    std::vector<std::int32_t> cells;           // Flat index per target number
+    std::vector<std::int32_t> componentStarts; // First target number of each connected component
+    std::vector<std::uint64_t> offsets;        // Runs of source r are runs[offsets[r], offsets[r + 1])
+    std::vector<std::uint32_t> runs;           // (first target number << 3) | direction
+};
+
+// Walks the table from ctx.start to ctx.goal, filling g and parent of every cell on the
+// path (so reconstructPath works as after a search) and counting those cells as
+// nodesExplored. The table must have been built for ctx.grid.
+template <class Cost>
+bool firstMovePath(SearchContext& ctx, const FirstMoveTable<Cost>& table, SearchObserver* observer = nullptr);
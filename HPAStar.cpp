@@ -0,0 +1,394 @@
+#include "HPAStar.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+// Entrances at least this wide get a transition at each end instead of one in the middle
+static const int LONG_ENTRANCE = 6;
+
+// Breadth-first search that never leaves one cluster's rectangle. The cluster is copied
+// into a small padded array (walls around it, as in Grid) so the search needs no bounds
+// checks; dist and parent are indexed by position in that array. A scratch object must
+// not outlive changes to the grid, since it keeps the last cluster it copied.
+struct ClusterBfs {
+    vector<char> open;
+    vector<int> dist, parent, queue;
+    int cluster = -1, x0 = 0, y0 = 0, width = 0, base = 0, stride = 0;
+    int offset[DIRS_4];
+
+    int local(const Grid& grid, int cell) const {
+        Point p = grid.point(cell);
+        return (p.x - x0 + 1) * width + (p.y - y0 + 1);
+    }
+    int cellAt(int l) const { return base + (l / width) * stride + l % width; }
+    int distance(const Grid& grid, int cell) const { return dist[local(grid, cell)]; }
+
+    // Labels every cell of the cluster reachable from `from`; stops early once `stop` is reached
+    void run(const Grid& grid, const HPAGraph& graph, int k, int from, int stop = -1) {
+        if (k != cluster) {
+            int x1, y1;
+            graph.bounds(k, x0, y0, x1, y1);
+            cluster = k;
+            width = y1 - y0 + 2;
+            stride = grid.stride();
+            base = grid.index(x0 - 1, y0 - 1);
+            for (int i = 0; i < DIRS_4; ++i) offset[i] = dx_4[i] * width + dy_4[i];
+            open.assign(static_cast<size_t>(x1 - x0 + 2) * width, 0);
+            for (int x = x0; x < x1; ++x)
+                for (int y = y0; y < y1; ++y) open[(x - x0 + 1) * width + (y - y0 + 1)] = grid.at(x, y) != WALL;
+        }
+        dist.assign(open.size(), -1);
+        parent.resize(open.size());
+        queue.clear();
+
+        int start = local(grid, from), target = stop < 0 ? -1 : local(grid, stop);
+        dist[start] = 0;
+        queue.push_back(start);
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int l = queue[head];
+            if (l == target) return;
+            for (int i = 0; i < DIRS_4; ++i) {
+                int n = l + offset[i];
+                if (!open[n] || dist[n] >= 0) continue;
+                dist[n] = dist[l] + 1;
+                parent[n] = l;
+                queue.push_back(n);
+            }
+        }
+    }
+};
+
+void HPAGraph::bounds(int cluster, int& x0, int& y0, int& x1, int& y1) const {
+    x0 = cluster / clusterCols * size;
+    y0 = cluster % clusterCols * size;
+    x1 = min(x0 + size, rows_);
+    y1 = min(y0 + size, cols_);
+}
+
+size_t HPAGraph::memoryBytes() const {
+    size_t bytes = nodeOf.size() * sizeof(int) + nodes.size() * sizeof(Node) + freeIds.size() * sizeof(int);
+    for (const Node& n : nodes) bytes += n.edges.size() * sizeof(Edge);
+    for (const vector<int>& m : members) bytes += sizeof(m) + m.size() * sizeof(int);
+    for (const auto& t : transitions) bytes += sizeof(t) + t.size() * sizeof(pair<int, int>);
+    return bytes;
+}
+
+// Scans both sides of a border for runs of open cell pairs
+void HPAGraph::findTransitions(const Grid& grid, int border) {
+    vector<pair<int, int>>& out = transitions[border];
+    out.clear();
+    int cluster = border / 2;
+    int x0, y0, x1, y1;
+    bounds(cluster, x0, y0, x1, y1);
+    bool below = border % 2 == 0;
+    if (below ? x1 >= rows_ : y1 >= cols_) return; // Edge of the map
+
+    // Cell pairs facing each other across the border, for position i along it
+    int length = below ? y1 - y0 : x1 - x0;
+    auto near = [&](int i) { return below ? grid.index(x1 - 1, y0 + i) : grid.index(x0 + i, y1 - 1); };
+    int across = below ? stride : 1;
+
+    for (int i = 0; i < length;) {
+        if (!grid.isValid(near(i)) || !grid.isValid(near(i) + across)) {
+            ++i;
+            continue;
+        }
+        int start = i;
+        while (i < length && grid.isValid(near(i)) && grid.isValid(near(i) + across)) ++i;
+        if (i - start >= LONG_ENTRANCE) {
+            out.push_back({ near(start), near(start) + across });
+            out.push_back({ near(i - 1), near(i - 1) + across });
+        }
+        else {
+            int mid = start + (i - start - 1) / 2;
+            out.push_back({ near(mid), near(mid) + across });
+        }
+    }
+}
+
+void HPAGraph::build(const Grid& grid, int clusterSize) {
+    rows_ = grid.rows();
+    cols_ = grid.cols();
+    stride = grid.stride();
+    size = max(2, clusterSize);
+    clusterRows = (rows_ + size - 1) / size;
+    clusterCols = (cols_ + size - 1) / size;
+    int clusters = clusterRows * clusterCols;
+
+    nodeOf.assign(grid.size(), -1);
+    nodes.clear();
+    freeIds.clear();
+    members.assign(clusters, vector<int>());
+    transitions.assign(static_cast<size_t>(clusters) * 2, vector<pair<int, int>>());
+
+    vector<int> borders(transitions.size()), all(clusters);
+    for (size_t b = 0; b < borders.size(); ++b) borders[b] = static_cast<int>(b);
+    for (int k = 0; k < clusters; ++k) all[k] = k;
+    rebuild(grid, borders, all);
+}
+
+void HPAGraph::update(const Grid& grid, const vector<Point>& changed) {
+    vector<int> borders, clusters;
+    for (const Point& p : changed) {
+        int k = clusterOf(grid.index(p.x, p.y));
+        int x0, y0, x1, y1;
+        bounds(k, x0, y0, x1, y1);
+        clusters.push_back(k);
+        // A cell on the edge of its cluster is part of the border there
+        if (p.x == x1 - 1 && x1 < rows_) {
+            borders.push_back(2 * k);
+            clusters.push_back(k + clusterCols);
+        }
+        if (p.x == x0 && x0 > 0) {
+            borders.push_back(2 * (k - clusterCols));
+            clusters.push_back(k - clusterCols);
+        }
+        if (p.y == y1 - 1 && y1 < cols_) {
+            borders.push_back(2 * k + 1);
+            clusters.push_back(k + 1);
+        }
+        if (p.y == y0 && y0 > 0) {
+            borders.push_back(2 * (k - 1) + 1);
+            clusters.push_back(k - 1);
+        }
+    }
+    sort(borders.begin(), borders.end());
+    borders.erase(unique(borders.begin(), borders.end()), borders.end());
+    sort(clusters.begin(), clusters.end());
+    clusters.erase(unique(clusters.begin(), clusters.end()), clusters.end());
+    rebuild(grid, borders, clusters);
+}
+
+void HPAGraph::rebuild(const Grid& grid, const vector<int>& dirtyBorders, const vector<int>& dirtyClusters) {
+    for (int b : dirtyBorders) findTransitions(grid, b);
+
+    // Borders of a cluster: below, right, above (below the cluster upstairs), left
+    auto bordersOf = [&](int k, int out[4]) {
+        int n = 0;
+        out[n++] = 2 * k;
+        out[n++] = 2 * k + 1;
+        if (k >= clusterCols) out[n++] = 2 * (k - clusterCols);
+        if (k % clusterCols > 0) out[n++] = 2 * (k - 1) + 1;
+        return n;
+    };
+
+    // Drop every edge of the dirty clusters' nodes, including the other ends of their
+    // transition edges, then bring each cluster's node set in line with its borders
+    for (int k : dirtyClusters) {
+        for (int id : members[k]) {
+            for (const Edge& e : nodes[id].edges) {
+                vector<Edge>& back = nodes[e.to].edges;
+                if (nodes[e.to].cluster != k)
+                    back.erase(remove_if(back.begin(), back.end(), [id](const Edge& x) { return x.to == id; }), back.end());
+            }
+            nodes[id].edges.clear();
+        }
+
+        vector<int> wanted;
+        int borders[4];
+        for (int i = 0, n = bordersOf(k, borders); i < n; ++i) {
+            for (const pair<int, int>& t : transitions[borders[i]]) {
+                if (clusterOf(t.first) == k) wanted.push_back(t.first);
+                if (clusterOf(t.second) == k) wanted.push_back(t.second);
+            }
+        }
+        sort(wanted.begin(), wanted.end());
+        wanted.erase(unique(wanted.begin(), wanted.end()), wanted.end());
+
+        for (int id : members[k]) {
+            if (binary_search(wanted.begin(), wanted.end(), nodes[id].cell)) continue;
+            nodeOf[nodes[id].cell] = -1;
+            nodes[id].cell = -1;
+            nodes[id].cluster = -1;
+            freeIds.push_back(id);
+        }
+        members[k].clear();
+        for (int cell : wanted) {
+            if (nodeOf[cell] < 0) {
+                int id;
+                if (!freeIds.empty()) {
+                    id = freeIds.back();
+                    freeIds.pop_back();
+                }
+                else {
+                    id = static_cast<int>(nodes.size());
+                    nodes.push_back(Node());
+                }
+                nodes[id].cell = cell;
+                nodes[id].cluster = k;
+                nodeOf[cell] = id;
+            }
+            members[k].push_back(nodeOf[cell]);
+        }
+    }
+
+    // Transition edges on every border of a dirty cluster, each border once
+    vector<int> borders;
+    for (int k : dirtyClusters) {
+        int b[4];
+        borders.insert(borders.end(), b, b + bordersOf(k, b));
+    }
+    sort(borders.begin(), borders.end());
+    borders.erase(unique(borders.begin(), borders.end()), borders.end());
+    for (int b : borders) {
+        for (const pair<int, int>& t : transitions[b]) {
+            int u = nodeOf[t.first], v = nodeOf[t.second];
+            nodes[u].edges.push_back({ v, 1 });
+            nodes[v].edges.push_back({ u, 1 });
+        }
+    }
+
+    // Intra-cluster distances; clusters are independent, so they're spread over threads
+    int threads = dirtyClusters.size() >= 64 ? defaultThreadCount() : 1;
+    vector<ClusterBfs> scratch(threads);
+    parallelFor(static_cast<int>(dirtyClusters.size()), threads, [&](int i, int worker) {
+        int k = dirtyClusters[i];
+        ClusterBfs& bfs = scratch[worker];
+        for (int id : members[k]) {
+            bfs.run(grid, *this, k, nodes[id].cell);
+            for (int other : members[k]) {
+                int d = other == id ? -1 : bfs.distance(grid, nodes[other].cell);
+                if (d > 0) nodes[id].edges.push_back({ other, d });
+            }
+        }
+    });
+    rebuilt = static_cast<int>(dirtyClusters.size());
+}
+
+// Buffers of one thread's queries, kept so that a warmed-up thread's queries don't
+// allocate. The abstract graph and the SearchContext hold nothing HPA*-specific to put
+// them in, and every query recopies the clusters it searches, so nothing in here depends
+// on the grid of the previous query.
+struct HpaScratch {
+    ClusterBfs bfs;
+    vector<HPAGraph::Edge> startEdges;
+    vector<int> toGoal, waypoints, leg;
+};
+static thread_local HpaScratch hpaScratch;
+
+template <class OpenList>
+bool hpaStar(SearchContext& ctx, const HPAGraph& graph, OpenList& open, SearchObserver* observer) {
+    ctx.reset();
+    ctx.prepareBackward();
+    const Grid& grid = *ctx.grid;
+    int s = grid.index(ctx.start.x, ctx.start.y);
+    int t = grid.index(ctx.goal.x, ctx.goal.y);
+    if (!grid.isValid(s) || !grid.isValid(t)) return false;
+
+    // Edges from the start into its cluster, and from the goal cluster's nodes to the goal
+    int startCluster = graph.clusterOf(s), goalCluster = graph.clusterOf(t);
+    HpaScratch& scratch = hpaScratch;
+    ClusterBfs& bfs = scratch.bfs;
+    bfs.cluster = -1; // The grid may have changed since this thread's last query
+    vector<HPAGraph::Edge>& startEdges = scratch.startEdges; // `to` holds a flat index here
+    startEdges.clear();
+    bfs.run(grid, graph, startCluster, s);
+    for (int id : graph.clusterNodes(startCluster)) {
+        int d = bfs.distance(grid, graph.node(id).cell);
+        if (d > 0) startEdges.push_back({ graph.node(id).cell, d });
+    }
+    if (startCluster == goalCluster && bfs.distance(grid, t) >= 0) startEdges.push_back({ t, bfs.distance(grid, t) });
+    bfs.run(grid, graph, goalCluster, t);
+    const vector<int>& goalNodes = graph.clusterNodes(goalCluster);
+    vector<int>& toGoal = scratch.toGoal;
+    toGoal.resize(goalNodes.size());
+    for (size_t i = 0; i < goalNodes.size(); ++i) toGoal[i] = bfs.distance(grid, graph.node(goalNodes[i]).cell);
+
+    // A* over abstract nodes, keyed by their cells
+    ctx.backNode(s).g = 0;
+    ctx.backNode(s).parent = s;
+    open.clear(grid.size());
+    open.push(heuristic_manhattan(ctx.start, ctx.goal), s);
+    ctx.stats.pushes++;
+
+    auto relax = [&](int from, int to, int cost) {
+        NodeState& n = ctx.backNode(to);
+        int g = ctx.backNode(from).g + cost;
+        if (g >= n.g) return;
+        n.g = g;
+        n.parent = from;
+        open.push(g + heuristic_manhattan(grid.point(to), ctx.goal), to);
+        ctx.stats.pushes++;
+        if (observer) observer->onVisit(grid.point(to));
+    };
+
+    bool found = false;
+    while (!open.empty()) {
+        int curr = open.pop();
+        ctx.stats.pops++;
+        NodeState& c = ctx.backNode(curr);
+        if (c.visited) {
+            PROFILE_COUNT(stalePops);
+            continue;
+        }
+        c.visited = true;
+        ctx.stats.nodesExplored++;
+        if (observer) observer->onExpand(grid.point(curr));
+        if (curr == t) {
+            found = true;
+            break;
+        }
+
+        if (curr == s)
+            for (const HPAGraph::Edge& e : startEdges) relax(curr, e.to, e.cost);
+        int id = graph.nodeAt(curr);
+        if (id < 0) continue;
+        for (const HPAGraph::Edge& e : graph.node(id).edges) relax(curr, graph.node(e.to).cell, e.cost);
+        if (graph.node(id).cluster == goalCluster) {
+            size_t i = find(goalNodes.begin(), goalNodes.end(), id) - goalNodes.begin();
+            if (toGoal[i] > 0) relax(curr, t, toGoal[i]);
+        }
+    }
+    if (!found) return false;
+
+    // Refine: replay each abstract edge as a path inside its cluster
+    vector<int>& waypoints = scratch.waypoints;
+    waypoints.clear();
+    for (int idx = t; idx != s; idx = ctx.backNodes[idx].parent) waypoints.push_back(idx);
+    waypoints.push_back(s);
+    reverse(waypoints.begin(), waypoints.end());
+
+    NodeState& first = ctx.node(s);
+    first.g = 0;
+    first.parent = s;
+    first.visited = true;
+    vector<int>& leg = scratch.leg;
+    for (size_t i = 0; i + 1 < waypoints.size(); ++i) {
+        int a = waypoints[i], b = waypoints[i + 1];
+        leg.clear();
+        if (abs(a - b) == 1 || abs(a - b) == grid.stride()) {
+            leg.push_back(b);
+        }
+        else {
+            bfs.run(grid, graph, graph.clusterOf(a), a, b);
+            for (int l = bfs.local(grid, b); l != bfs.local(grid, a); l = bfs.parent[l]) leg.push_back(bfs.cellAt(l));
+            reverse(leg.begin(), leg.end());
+        }
+        int prev = a;
+        for (int idx : leg) {
+            // A leg can cross an earlier one; keep the first visit, which cuts the loop out
+            if (ctx.touched(idx) && ctx.nodes[idx].visited) {
+                prev = idx;
+                continue;
+            }
+            NodeState& n = ctx.node(idx);
+            n.g = ctx.node(prev).g + 1;
+            n.parent = prev;
+            n.visited = true;
+            prev = idx;
+        }
+    }
+    return true;
+}
+
+bool hpaStar(SearchContext& ctx, const HPAGraph& graph, SearchObserver* observer) {
+    return hpaStar(ctx, graph, ctx.open, observer);
+}
+
+template bool hpaStar<BinaryHeapOpenList>(SearchContext&, const HPAGraph&, BinaryHeapOpenList&, SearchObserver*);
+template bool hpaStar<BucketQueue>(SearchContext&, const HPAGraph&, BucketQueue&, SearchObserver*);
+template bool hpaStar<RadixHeap>(SearchContext&, const HPAGraph&, RadixHeap&, SearchObserver*);
+template bool hpaStar<QuaternaryHeap>(SearchContext&, const HPAGraph&, QuaternaryHeap&, SearchObserver*);
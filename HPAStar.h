@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include "Pathfinder.h"
+
+// Abstract graph for HPA* (Botea, Mueller & Schaeffer). The grid is cut into square
+// clusters. Each maximal run of cells open on both sides of a cluster border is an
+// entrance with one transition in its middle, or one at each end if it is long; the two
+// cells of a transition become abstract nodes joined by an edge of cost 1. Nodes of the
+// same cluster are joined by edges carrying their shortest distance inside the cluster.
+class HPAGraph {
+public:
+    struct Edge {
+        int to;   // Node id
+        int cost; // Grid steps
+    };
+    struct Node {
+        int cell = -1;    // Flat grid index, -1 for a free slot
+        int cluster = -1;
+        std::vector<Edge> edges;
+    };
+
+    // Builds the graph for grid with clusterSize x clusterSize clusters
+    void build(const Grid& grid, int clusterSize = 16);
+    // Call after cells of the grid passed to build() flip between WALL and PATH. Only the
+    // clusters containing a changed cell, and the neighbours sharing a border the cell
+    // lies on, get their entrances and intra-cluster distances recomputed.
+    void update(const Grid& grid, const std::vector<Point>& changed);
+
+    int clusterSize() const { return size; }
+    int clusterOf(int cell) const {
+        return ((cell / stride) - 1) / size * clusterCols + ((cell % stride) - 1) / size;
+    }
+    // Cells [x0, x1) x [y0, y1) of a cluster
+    void bounds(int cluster, int& x0, int& y0, int& x1, int& y1) const;
+    // Node id of a cell, or -1 if the cell isn't an abstract node
+    int nodeAt(int cell) const { return nodeOf[cell]; }
+    const Node& node(int id) const { return nodes[id]; }
+    const std::vector<int>& clusterNodes(int cluster) const { return members[cluster]; }
+
+    int nodeCount() const { return static_cast<int>(nodes.size() - freeIds.size()); }
+    // Clusters whose intra-cluster edges the last build() or update() recomputed
+    int clustersRebuilt() const { return rebuilt; }
+    bool matches(const Grid& grid) const { return rows_ == grid.rows() && cols_ == grid.cols(); }
+    size_t memoryBytes() const;
+
+private:
+    void rebuild(const Grid& grid, const std::vector<int>& dirtyBorders, const std::vector<int>& dirtyClusters);
+    void findTransitions(const Grid& grid, int border);
+
+    int rows_ = 0, cols_ = 0, stride = 0, size = 16;
+    int clusterRows = 0, clusterCols = 0;
+    std::vector<int> nodeOf;       // Per flat grid index
+    std::vector<Node> nodes;
+    std::vector<int> freeIds;
+    std::vector<std::vector<int>> members; // Node ids per cluster
+    // Transitions as (cell, cell) pairs, per border. Border 2k is the one below cluster k
+    // and border 2k + 1 the one to its right.
+    std::vector<std::vector<std::pair<int, int>>> transitions;
+    int rebuilt = 0;
+};
+
+// HPA* query: connects ctx.start and ctx.goal to the nodes of their clusters, runs A*
+// (Manhattan heuristic) on the abstract graph over ctx.backNode records, then refines
+// each abstract edge into grid cells with a search confined to its cluster. The path is
+// left in ctx.nodes as for the other solvers. Paths are near-optimal, not optimal.
+// stats.nodesExplored counts abstract nodes expanded.
+template <class OpenList>
+bool hpaStar(SearchContext& ctx, const HPAGraph& graph, OpenList& open, SearchObserver* observer = nullptr);
+bool hpaStar(SearchContext& ctx, const HPAGraph& graph, SearchObserver* observer = nullptr);
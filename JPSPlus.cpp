@@ -0,0 +1,207 @@
+#include "JPSPlus.h"
+#include "JumpPoint.h"
+
+#include <algorithm>
+#include <fstream>
+#include <cstdlib>
+
+using namespace std;
+
+// Direction indices (into dx_8/dy_8) of the vertical and horizontal components of a move
+static int verticalDir(int dx) { return dx < 0 ? 0 : 4; }
+static int horizontalDir(int dy) { return dy > 0 ? 2 : 6; }
+
+// Same forced-neighbour tests as the grid-scanning jump
+static bool cardinalForced(const Grid& grid, int idx, int step, int side) {
+    return (grid.isValid(idx + step - side) && !grid.isValid(idx - side)) ||
+        (grid.isValid(idx + step + side) && !grid.isValid(idx + side));
+}
+
+static bool diagonalForced(const Grid& grid, int idx, int vertical, int dy) {
+    return (grid.isValid(idx - vertical + dy) && !grid.isValid(idx - vertical)) ||
+        (grid.isValid(idx + vertical - dy) && !grid.isValid(idx - dy));
+}
+
+void JPSPlusTable::build(const Grid& grid) {
+    rows_ = grid.rows();
+    cols_ = grid.cols();
+    dist.assign(static_cast<size_t>(grid.size()) * DIRS_8, 0);
+    entries = dist.data();
+    int stride = grid.stride();
+
+    // Cardinal directions first, since diagonal stops depend on them
+    const int order[DIRS_8] = { 0, 2, 4, 6, 1, 3, 5, 7 };
+    for (int dir : order) {
+        int dx = dx_8[dir], dy = dy_8[dir];
+        int step = grid.offset8[dir];
+        bool diagonal = dx != 0 && dy != 0;
+
+        // Sweep against the direction of travel so each cell's successor is already done
+        for (int xi = 0; xi < rows_; ++xi) {
+            int x = dx > 0 ? rows_ - 1 - xi : xi;
+            for (int yi = 0; yi < cols_; ++yi) {
+                int y = dy > 0 ? cols_ - 1 - yi : yi;
+                int idx = grid.index(x, y);
+                int next = idx + step;
+                if (!grid.isValid(next)) {
+                    dist[static_cast<size_t>(idx) * DIRS_8 + dir] = 0;
+                    continue;
+                }
+
+                bool stop;
+                if (!diagonal)
+                    stop = cardinalForced(grid, next, step, dx != 0 ? 1 : stride);
+                else
+                    stop = diagonalForced(grid, next, dx * stride, dy) ||
+                        distance(next, verticalDir(dx)) > 0 || distance(next, horizontalDir(dy)) > 0;
+
+                int32_t d = 1;
+                if (!stop) {
+                    int32_t after = distance(next, dir);
+                    d = after > 0 ? after + 1 : after - 1;
+                }
+                dist[static_cast<size_t>(idx) * DIRS_8 + dir] = d;
+            }
+        }
+    }
+}
+
+// File layout: "JPSP", format version, rows, cols, then the raw distance array
+static const char TABLE_MAGIC[4] = { 'J', 'P', 'S', 'P' };
+static const int32_t TABLE_VERSION = 1;
+
+bool JPSPlusTable::save(const string& path) const {
+    ofstream out(path, ios::binary);
+    if (!out) return false;
+    int32_t header[3] = { TABLE_VERSION, rows_, cols_ };
+    out.write(TABLE_MAGIC, sizeof(TABLE_MAGIC));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries), (entries ? entryCount() : 0) * sizeof(int32_t));
+    return static_cast<bool>(out);
+}
+
+bool JPSPlusTable::load(const string& path, const Grid& grid) {
+    clear();
+    ifstream in(path, ios::binary | ios::ate);
+    uint64_t fileBytes = in ? static_cast<uint64_t>(in.tellg()) : 0;
+    in.seekg(0);
+    char magic[4];
+    int32_t header[3];
+    if (!in.read(magic, sizeof(magic)) || !in.read(reinterpret_cast<char*>(header), sizeof(header)))
+        return false;
+    // The distances must fill the rest of the file exactly
+    uint64_t entryBytes = static_cast<uint64_t>(grid.size()) * DIRS_8 * sizeof(int32_t);
+    if (!equal(magic, magic + 4, TABLE_MAGIC) || header[0] != TABLE_VERSION ||
+        header[1] != grid.rows() || header[2] != grid.cols() || fileBytes != sizeof(magic) + sizeof(header) + entryBytes)
+        return false;
+
+    dist.resize(static_cast<size_t>(grid.size()) * DIRS_8);
+    if (!in.read(reinterpret_cast<char*>(dist.data()), entryBytes) || !validEntries(dist.data(), grid)) {
+        clear();
+        return false;
+    }
+    rows_ = header[1];
+    cols_ = header[2];
+    entries = dist.data();
+    return true;
+}
+
+// Checks what TableJumper relies on: from every cell, each ray's last open cell (-d steps
+// away for d <= 0) or jump point (d > 0) lies inside the padded grid and is open
+bool JPSPlusTable::validEntries(const int32_t* entries, const Grid& grid) {
+    for (int idx = 0; idx < grid.size(); ++idx) {
+        for (int dir = 0; dir < DIRS_8; ++dir) {
+            int64_t d = entries[static_cast<size_t>(idx) * DIRS_8 + dir];
+            if (d == 0) continue;
+            int64_t end = idx + (d > 0 ? d : -d) * grid.offset8[dir];
+            if (end < 0 || end >= grid.size() || !grid.isValid(static_cast<int>(end))) return false;
+        }
+    }
+    return true;
+}
+
+void JPSPlusTable::clear() {
+    rows_ = cols_ = 0;
+    vector<int32_t>().swap(dist);
+    entries = nullptr;
+}
+
+bool JPSPlusTable::attach(const int32_t* data, const Grid& grid) {
+    clear();
+    if (!validEntries(data, grid)) return false;
+    rows_ = grid.rows();
+    cols_ = grid.cols();
+    entries = data;
+    return true;
+}
+
+// Table-driven jump. The table ignores the goal, so each jump also checks whether the
+// goal lies on the ray (or, for diagonals, on one of the cardinal probes) before the
+// stored stop, which is where the scanning jump would have stopped for it.
+struct TableJumper {
+    const Grid& grid;
+    const JPSPlusTable& table;
+    int gx, gy; // Goal coordinates
+
+    bool operator()(int from, int dir, int end, int& out) const {
+        int dx = dx_8[dir], dy = dy_8[dir];
+        int step = grid.offset8[dir];
+        int d = table.distance(from, dir);
+        PROFILE_COUNT(jumpSteps);
+        int reach = d > 0 ? d : -d; // Open cells the ray may visit
+        Point f = grid.point(from);
+
+        if (dx == 0 || dy == 0) {
+            // Goal on the ray before the jump point or wall
+            int ahead = dx != 0 ? (gx - f.x) * dx : (gy - f.y) * dy;
+            bool inLine = dx != 0 ? gy == f.y : gx == f.x;
+            if (inLine && ahead >= 1 && ahead <= reach) {
+                out = end;
+                return true;
+            }
+            if (d <= 0) return false;
+            out = from + d * step;
+            return true;
+        }
+
+        int best = d > 0 ? d : reach + 1;
+        // Goal on the diagonal itself
+        int j = (gx - f.x) * dx;
+        if (j >= 1 && j < best && (gy - f.y) * dy == j) best = j;
+        // Goal on the vertical probe from the diagonal cell in the goal's column
+        j = (gy - f.y) * dy;
+        if (j >= 1 && j < best) {
+            int ahead = (gx - (f.x + j * dx)) * dx;
+            int probe = table.distance(from + j * step, verticalDir(dx));
+            PROFILE_COUNT(jumpSteps);
+            if (ahead >= 1 && ahead <= abs(probe)) best = j;
+        }
+        // Goal on the horizontal probe from the diagonal cell in the goal's row
+        j = (gx - f.x) * dx;
+        if (j >= 1 && j < best) {
+            int ahead = (gy - (f.y + j * dy)) * dy;
+            int probe = table.distance(from + j * step, horizontalDir(dy));
+            PROFILE_COUNT(jumpSteps);
+            if (ahead >= 1 && ahead <= abs(probe)) best = j;
+        }
+
+        if (best > reach) return false;
+        out = from + best * step;
+        return true;
+    }
+};
+
+template <class OpenList>
+bool jpsPlus(SearchContext& ctx, const JPSPlusTable& table, OpenList& open, SearchObserver* observer) {
+    TableJumper jump = { *ctx.grid, table, ctx.goal.x, ctx.goal.y };
+    return jumpPointSearch(ctx, open, jump, observer);
+}
+
+bool jpsPlus(SearchContext& ctx, const JPSPlusTable& table, SearchObserver* observer) {
+    return jpsPlus(ctx, table, ctx.open, observer);
+}
+
+template bool jpsPlus<BinaryHeapOpenList>(SearchContext&, const JPSPlusTable&, BinaryHeapOpenList&, SearchObserver*);
+template bool jpsPlus<BucketQueue>(SearchContext&, const JPSPlusTable&, BucketQueue&, SearchObserver*);
+template bool jpsPlus<RadixHeap>(SearchContext&, const JPSPlusTable&, RadixHeap&, SearchObserver*);
+template bool jpsPlus<QuaternaryHeap>(SearchContext&, const JPSPlusTable&, QuaternaryHeap&, SearchObserver*);
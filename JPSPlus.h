@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Pathfinder.h"
+
+// JPS+ jump-distance table for a static grid. For every cell and each of the 8
+// directions (indices into dx_8/dy_8) it stores where the goal-independent jump from
+// that cell lands:
+//   d > 0   the jump point is d steps away
+//   d <= 0  no jump point; the ray crosses -d open cells and then hits a wall
+// At query time jpsPlus turns each jump into a lookup, plus an O(1) check for the
+// goal lying on the ray, and returns the same results as jps.
+class JPSPlusTable {
+public:
+    // Precomputes all distances with one sweep per direction: O(cells)
+    void build(const Grid& grid);
+
+    // Stores the table next to its map (e.g. "maze.jpsp"). Both return false on I/O errors;
+    // load also fails if the file was built for a grid of different dimensions or has a
+    // distance that leaves the grid or ends on a wall, and then leaves the table empty.
+    bool save(const std::string& path) const;
+    bool load(const std::string& path, const Grid& grid);
+
+    // Uses a table stored elsewhere, such as a section of a mapped map file, without
+    // copying it. data holds entryCount() values for grid and must outlive the table (or
+    // the next build/load/attach). Runs load's checks on the distances first; if they
+    // fail, returns false and leaves the table empty.
+    bool attach(const std::int32_t* data, const Grid& grid);
+
+    int distance(int idx, int dir) const { return entries[static_cast<size_t>(idx) * DIRS_8 + dir]; }
+    bool matches(const Grid& grid) const { return rows_ == grid.rows() && cols_ == grid.cols(); }
+    const std::int32_t* data() const { return entries; }
+    size_t entryCount() const { return static_cast<size_t>(rows_ + 2) * (cols_ + 2) * DIRS_8; }
+    // Heap memory owned by the table (0 when attached)
+    size_t memoryBytes() const { return dist.size() * sizeof(std::int32_t); }
+
+private:
+    static bool validEntries(const std::int32_t* entries, const Grid& grid);
+    void clear();
+
+    int rows_ = 0, cols_ = 0;
+    std::vector<std::int32_t> dist; // DIRS_8 entries per flat grid index, unless attached
+    const std::int32_t* entries = nullptr; // dist.data() or the attached table
+};
+
+// Jump Point Search using a JPSPlusTable built from ctx.grid
+template <class OpenList>
+bool jpsPlus(SearchContext& ctx, const JPSPlusTable& table, OpenList& open, SearchObserver* observer = nullptr);
+bool jpsPlus(SearchContext& ctx, const JPSPlusTable& table, SearchObserver* observer = nullptr);
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Pathfinder.h"
+
+// Best-first loop shared by the Jump Point Search variants, which differ only in how a
+// jump is found. Jumper is called as jump(from, dir, goal, out): starting at the neighbour
+// of `from` in direction dir (an index into dx_8/dy_8), it returns true and sets `out` to
+// the first jump point, or returns false if the ray ends in a wall. All positions are
+// flat indices into ctx.grid. A jump is a straight or diagonal run, so its cost is the
+// octile distance between its ends; g values are in COST_ONE units.
+template <class OpenList, class Jumper>
+bool jumpPointSearch(SearchContext& ctx, OpenList& open, const Jumper& jump, SearchObserver* observer) {
+    ctx.reset();
+    const Grid& grid = *ctx.grid;
+    int& nodesExplored = ctx.stats.nodesExplored;
+    int s = grid.index(ctx.start.x, ctx.start.y);
+    int t = grid.index(ctx.goal.x, ctx.goal.y);
+
+    ctx.node(s).g = 0;
+    ctx.node(s).parent = s;
+    open.clear(grid.size());
+    open.push(heuristic_octile(ctx.start, ctx.goal), s);
+    ctx.stats.pushes++;
+
+    while (!open.empty()) {
+        int curr = open.pop();
+        ctx.stats.pops++;
+        NodeState& c = ctx.node(curr);
+        if (c.visited) {
+            PROFILE_COUNT(stalePops);
+            continue;
+        }
+
+        c.visited = true;
+        nodesExplored++;
+        if (observer) observer->onExpand(grid.point(curr));
+
+        if (curr == t) return true;
+
+        Point cp = grid.point(curr);
+        for (int i = 0; i < DIRS_8; ++i) {
+            int jumpPoint;
+            PROFILE_COUNT(jumpCalls);
+            if (jump(curr, i, t, jumpPoint)) {
+                Point jp = grid.point(jumpPoint);
+                NodeState& n = ctx.node(jumpPoint);
+                int tentative_g = c.g + heuristic_octile(cp, jp);
+                if (tentative_g < n.g) {
+                    n.g = tentative_g;
+                    n.parent = curr;
+                    open.push(tentative_g + heuristic_octile(jp, ctx.goal), jumpPoint);
+                    ctx.stats.pushes++;
+
+                    if (observer) observer->onVisit(jp);
+                }
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,308 @@
+// Load generator for PathServer: measures sustained queries/sec and latency percentiles
+// against a server listening on a Unix domain socket.
+//
+// Usage:
+//   LoadGen --socket path [--connections 4] [--depth 16] [--seconds 5] [--warmup 1]
+//           [--queries 10000] [--seed 1] [--solver name] [--binary] [--nopath]
+//
+// Fetches `queries` random start/goal pairs from the server ("sample"), then runs
+// `connections` closed-loop clients, each keeping `depth` queries in flight (pipelined on
+// one connection) and sending a new one per answer. Queries answered during the first
+// `warmup` seconds are not counted; the report covers the next `seconds`. --binary uses
+// the binary protocol, --nopath asks it not to send paths back (binary only).
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+#include "PathServer.h"
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+typedef chrono::steady_clock Clock;
+
+// Returns the value after --name, or fallback if the flag wasn't given
+static string flagArg(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 0; i + 1 < argc; ++i)
+        if (argv[i] == "--" + name) return argv[i + 1];
+    return fallback;
+}
+
+static bool hasFlag(int argc, char* argv[], const string& name) {
+    for (int i = 0; i < argc; ++i)
+        if (argv[i] == "--" + name) return true;
+    return false;
+}
+
+#ifndef _WIN32
+static int connectTo(const string& path) {
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) return -1;
+    memcpy(addr.sun_path, path.c_str(), path.size());
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool sendAll(int fd, const string& data) {
+    for (size_t sent = 0; sent < data.size();) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Reads one text line (without '\n') from fd, buffering what follows it in `pending`
+static bool readLine(int fd, string& pending, string& line) {
+    char chunk[65536];
+    for (;;) {
+        size_t end = pending.find('\n');
+        if (end != string::npos) {
+            line = pending.substr(0, end);
+            pending.erase(0, end + 1);
+            return true;
+        }
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) return false;
+        pending.append(chunk, static_cast<size_t>(n));
+    }
+}
+#endif
+
+// What one client connection measured
+struct ClientResult {
+    vector<double> latencies; // Microseconds, queries sent inside the measured window
+    long long answered = 0;   // Answers received inside the measured window
+    long long found = 0, errors = 0;
+    long long serverMicros = 0; // Sum of the servers' own search times
+    bool failed = false;
+};
+
+struct LoadOptions {
+    string socket;
+    int depth;
+    bool binary, wantPath;
+    int solver; // Index for the binary protocol, -1 for the server's default
+    string solverName;
+};
+
+#ifndef _WIN32
+// Closed-loop client: keeps depth queries in flight until the window closes
+static void runClient(const LoadOptions& options, const vector<Point>& pairs, size_t first,
+    Clock::time_point measureFrom, Clock::time_point measureTo, ClientResult& result) {
+    int fd = connectTo(options.socket);
+    if (fd < 0) {
+        result.failed = true;
+        return;
+    }
+    deque<Clock::time_point> inFlight;
+    size_t next = first;
+    string out, pending;
+    auto addQuery = [&]() {
+        const Point* q = &pairs[2 * (next++ % (pairs.size() / 2))];
+        if (options.binary) {
+            BinaryQuery b = { q[0].x, q[0].y, q[1].x, q[1].y, options.solver, options.wantPath ? QUERY_WANT_PATH : 0 };
+            out.append(reinterpret_cast<const char*>(&b), sizeof(b));
+        }
+        else {
+            out += to_string(q[0].x) + " " + to_string(q[0].y) + " " + to_string(q[1].x) + " " + to_string(q[1].y);
+            out += options.solverName.empty() ? "\n" : " " + options.solverName + "\n";
+        }
+        inFlight.push_back(Clock::now());
+    };
+
+    if (options.binary) out.append(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    for (int i = 0; i < options.depth; ++i) addQuery();
+    char chunk[65536];
+    while (!inFlight.empty()) {
+        if (!out.empty() && !sendAll(fd, out)) break;
+        out.clear();
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) break;
+        pending.append(chunk, static_cast<size_t>(n));
+
+        // Every complete answer retires the oldest query in flight
+        size_t used = 0;
+        for (;;) {
+            int status;
+            long long micros;
+            if (options.binary) {
+                BinaryAnswer a;
+                if (pending.size() - used < sizeof(a)) break;
+                memcpy(&a, pending.data() + used, sizeof(a));
+                size_t bytes = sizeof(a) + static_cast<size_t>(a.pathLength) * 2 * sizeof(int32_t);
+                if (pending.size() - used < bytes) break;
+                used += bytes;
+                status = a.status;
+                micros = a.micros;
+            }
+            else {
+                size_t end = pending.find('\n', used);
+                if (end == string::npos) break;
+                // "seq found cost nodes pushes pops micros ..." or "seq error ..."
+                const char* p = pending.c_str() + used;
+                char* field;
+                strtoll(p, &field, 10);
+                p = field;
+                long long v[6];
+                int k = 0;
+                for (; k < 6; ++k, p = field) {
+                    v[k] = strtoll(p, &field, 10);
+                    if (field == p) break;
+                }
+                status = k == 6 ? static_cast<int>(v[0]) : -1;
+                micros = k == 6 ? v[5] : 0;
+                used = end + 1;
+            }
+
+            Clock::time_point now = Clock::now();
+            Clock::time_point sent = inFlight.front();
+            inFlight.pop_front();
+            if (sent >= measureFrom && sent < measureTo) {
+                result.latencies.push_back(chrono::duration<double, micro>(now - sent).count());
+                result.serverMicros += micros;
+                result.found += status == 1;
+                result.errors += status < 0;
+            }
+            if (now >= measureFrom && now < measureTo) result.answered++;
+            if (now < measureTo) addQuery();
+        }
+        pending.erase(0, used);
+    }
+    result.failed = !inFlight.empty();
+    close(fd);
+}
+#endif
+
+static double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t i = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[min(i, sorted.size() - 1)];
+}
+
+int main(int argc, char* argv[]) {
+#ifdef _WIN32
+    cerr << "LoadGen needs Unix domain sockets" << endl;
+    return 1;
+#else
+    LoadOptions options;
+    options.socket = flagArg(argc, argv, "socket", "");
+    if (options.socket.empty()) {
+        cerr << "Usage: LoadGen --socket path [--connections n] [--depth n] [--seconds s] [--warmup s]" << endl;
+        cerr << "               [--queries n] [--seed n] [--solver name] [--binary] [--nopath]" << endl;
+        return 1;
+    }
+    int connections = max(1, atoi(flagArg(argc, argv, "connections", "4").c_str()));
+    options.depth = max(1, atoi(flagArg(argc, argv, "depth", "16").c_str()));
+    double seconds = max(0.1, atof(flagArg(argc, argv, "seconds", "5").c_str()));
+    double warmup = max(0.0, atof(flagArg(argc, argv, "warmup", "1").c_str()));
+    int queries = max(1, atoi(flagArg(argc, argv, "queries", "10000").c_str()));
+    string seed = flagArg(argc, argv, "seed", "1");
+    options.binary = hasFlag(argc, argv, "binary");
+    options.wantPath = !hasFlag(argc, argv, "nopath");
+    options.solverName = flagArg(argc, argv, "solver", "");
+
+    // The map's size, solver list and a query set, from the server itself
+    int fd = connectTo(options.socket);
+    if (fd < 0) {
+        cerr << "Cannot connect to " << options.socket << endl;
+        return 1;
+    }
+    string pending, info, sample;
+    if (!sendAll(fd, "info\nsample " + to_string(queries) + " " + seed + "\nquit\n") ||
+        !readLine(fd, pending, info) || !readLine(fd, pending, sample)) {
+        cerr << "No answer from " << options.socket << endl;
+        return 1;
+    }
+    close(fd);
+
+    char names[4096] = "";
+    int rows = 0, cols = 0;
+    sscanf(info.c_str(), "%*d info %d %d %4095s", &rows, &cols, names);
+    options.solver = -1;
+    if (!options.solverName.empty()) {
+        string list = string(",") + names + ",";
+        size_t at = list.find("," + options.solverName + ",");
+        if (at == string::npos) {
+            cerr << "The server has no solver '" << options.solverName << "' (it has " << names << ")" << endl;
+            return 1;
+        }
+        options.solver = static_cast<int>(count(list.begin(), list.begin() + at + 1, ',')) - 1;
+    }
+    vector<Point> pairs;
+    const char* p = sample.c_str();
+    char* field;
+    strtol(p, &field, 10);
+    p = strstr(field, "sample");
+    if (!p) {
+        cerr << "Bad sample answer: " << sample << endl;
+        return 1;
+    }
+    p += strlen("sample");
+    for (long v[2]; ; p = field) {
+        v[0] = strtol(p, &field, 10);
+        if (field == p) break;
+        v[1] = strtol(p = field, &field, 10);
+        pairs.push_back(Point(static_cast<int>(v[0]), static_cast<int>(v[1])));
+    }
+
+    Clock::time_point start = Clock::now();
+    Clock::time_point measureFrom = start + chrono::duration_cast<Clock::duration>(chrono::duration<double>(warmup));
+    Clock::time_point measureTo = measureFrom + chrono::duration_cast<Clock::duration>(chrono::duration<double>(seconds));
+    vector<ClientResult> results(connections);
+    vector<thread> clients;
+    for (int c = 0; c < connections; ++c)
+        clients.emplace_back(runClient, cref(options), cref(pairs), static_cast<size_t>(c) * queries / connections,
+            measureFrom, measureTo, ref(results[c]));
+    for (thread& t : clients) t.join();
+
+    ClientResult total;
+    for (ClientResult& r : results) {
+        total.latencies.insert(total.latencies.end(), r.latencies.begin(), r.latencies.end());
+        total.answered += r.answered;
+        total.found += r.found;
+        total.errors += r.errors;
+        total.serverMicros += r.serverMicros;
+        total.failed = total.failed || r.failed;
+    }
+    sort(total.latencies.begin(), total.latencies.end());
+    size_t measured = max<size_t>(1, total.latencies.size());
+
+    cout << "Map " << rows << "x" << cols << ", " << pairs.size() / 2 << " distinct queries, solver "
+        << (options.solverName.empty() ? "(server default)" : options.solverName) << ", "
+        << (options.binary ? "binary" : "text") << (options.wantPath ? "" : " without paths") << endl;
+    cout << connections << " connections x " << options.depth << " in flight, " << seconds << " s measured after "
+        << warmup << " s warm-up" << endl;
+    cout << fixed << setprecision(0) << "Throughput: " << total.answered / seconds << " queries/s ("
+        << total.answered << " answered, " << total.found << " found, " << total.errors << " errors)" << endl;
+    cout << setprecision(1) << "Latency (us): mean " << (total.latencies.empty() ? 0.0 :
+        accumulate(total.latencies.begin(), total.latencies.end(), 0.0) / total.latencies.size())
+        << "  p50 " << percentile(total.latencies, 50) << "  p90 " << percentile(total.latencies, 90)
+        << "  p99 " << percentile(total.latencies, 99) << "  p99.9 " << percentile(total.latencies, 99.9)
+        << "  max " << (total.latencies.empty() ? 0.0 : total.latencies.back()) << endl;
+    cout << "Server search time (us): mean " << static_cast<double>(total.serverMicros) / measured << endl;
+    if (total.failed) cerr << "A connection failed before all its queries were answered" << endl;
+    return total.failed ? 1 : 0;
+#endif
+}
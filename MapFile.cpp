@@ -0,0 +1,233 @@
+#include "MapFile.h"
+#include "JPSPlus.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static const char MAP_MAGIC[4] = { 'P', 'F', 'M', 'P' };
+static const size_t SECTION_ALIGN = 64;
+
+static size_t alignUp(size_t n) { return (n + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN; }
+
+bool MapFile::open(const string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER length;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &length) && length.QuadPart > 0)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    size = static_cast<size_t>(length.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+        view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps the file alive
+    if (view == MAP_FAILED) return false;
+    size = static_cast<size_t>(info.st_size);
+#endif
+    data = static_cast<const unsigned char*>(view);
+
+    // Header, section table and the wall layer must all lie inside the file
+    header = reinterpret_cast<const MapHeader*>(data);
+    bool valid = size >= sizeof(MapHeader) && memcmp(header->magic, MAP_MAGIC, 4) == 0 &&
+        header->version == MAP_VERSION && header->rows > 0 && header->cols > 0 &&
+        size >= sizeof(MapHeader) + static_cast<size_t>(header->sectionCount) * sizeof(MapSection);
+    if (valid) {
+        const MapSection* sections = reinterpret_cast<const MapSection*>(data + sizeof(MapHeader));
+        for (uint32_t i = 0; i < header->sectionCount && valid; ++i)
+            valid = sections[i].offset % SECTION_ALIGN == 0 && sections[i].offset <= size &&
+                sections[i].bytes <= size - sections[i].offset;
+    }
+    size_t bytes = 0;
+    walls = valid ? static_cast<const uint64_t*>(section(MapSectionType::Walls, bytes)) : nullptr;
+    if (!walls || bytes < static_cast<size_t>(rows()) * rowWords() * sizeof(uint64_t)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MapFile::close() {
+    if (!data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+    fileHandle = mappingHandle = nullptr;
+#else
+    munmap(const_cast<unsigned char*>(data), size);
+#endif
+    data = nullptr;
+    header = nullptr;
+    walls = nullptr;
+    size = 0;
+}
+
+const void* MapFile::section(MapSectionType type, size_t& bytes) const {
+    const MapSection* sections = reinterpret_cast<const MapSection*>(data + sizeof(MapHeader));
+    for (uint32_t i = 0; i < header->sectionCount; ++i) {
+        if (sections[i].type != static_cast<uint32_t>(type)) continue;
+        bytes = static_cast<size_t>(sections[i].bytes);
+        return data + sections[i].offset;
+    }
+    bytes = 0;
+    return nullptr;
+}
+
+// EXPAND[b] holds the eight cells for the eight wall bits of b, lowest bit first
+struct WallExpansion {
+    uint64_t cells[256];
+    WallExpansion() {
+        for (int b = 0; b < 256; ++b) {
+            char bytes[8];
+            for (int k = 0; k < 8; ++k) bytes[k] = (b >> k) & 1 ? WALL : PATH;
+            memcpy(&cells[b], bytes, 8);
+        }
+    }
+};
+static const WallExpansion EXPAND;
+
+void loadGrid(const MapFile& file, Grid& grid) {
+    int rows = file.rows(), cols = file.cols();
+    grid.resize(rows, cols);
+    for (int x = 0; x < rows; ++x) {
+        const uint64_t* bits = file.wallRow(x);
+        char* row = &grid.at(x, 0);
+        int y = 0;
+        for (; y + 8 <= cols; y += 8)
+            memcpy(row + y, &EXPAND.cells[(bits[y >> 6] >> (y & 63)) & 0xff], 8);
+        for (; y < cols; ++y) row[y] = file.isWall(x, y) ? WALL : PATH;
+    }
+
+    Point s = file.start(), t = file.goal();
+    if (grid.inBounds(s.x, s.y)) grid.at(s.x, s.y) = START;
+    if (grid.inBounds(t.x, t.y)) grid.at(t.x, t.y) = END;
+}
+
+bool attachJpsPlus(const MapFile& file, const Grid& grid, JPSPlusTable& table) {
+    size_t bytes = 0;
+    const void* entries = file.section(MapSectionType::JpsPlus, bytes);
+    size_t expected = static_cast<size_t>(file.rows() + 2) * (file.cols() + 2) * DIRS_8 * sizeof(int32_t);
+    if (!entries || bytes != expected || grid.rows() != file.rows() || grid.cols() != file.cols()) return false;
+    return table.attach(static_cast<const int32_t*>(entries), grid);
+}
+
+bool saveMap(const string& path, const Grid& grid, Point start, Point goal, const JPSPlusTable* table) {
+    bool withTable = table && table->matches(grid) && table->data();
+    MapHeader header = {};
+    memcpy(header.magic, MAP_MAGIC, 4);
+    header.version = MAP_VERSION;
+    header.rows = grid.rows();
+    header.cols = grid.cols();
+    header.startX = start.x;
+    header.startY = start.y;
+    header.goalX = goal.x;
+    header.goalY = goal.y;
+    header.sectionCount = withTable ? 2 : 1;
+
+    // Wall layer, row by row
+    int rowWords = (grid.cols() + 63) / 64;
+    vector<uint64_t> walls(static_cast<size_t>(grid.rows()) * rowWords, 0);
+    for (int x = 0; x < grid.rows(); ++x)
+        for (int y = 0; y < grid.cols(); ++y)
+            if (grid.at(x, y) == WALL) walls[static_cast<size_t>(x) * rowWords + (y >> 6)] |= 1ULL << (y & 63);
+
+    MapSection sections[2] = {};
+    sections[0].type = static_cast<uint32_t>(MapSectionType::Walls);
+    sections[0].offset = alignUp(sizeof(MapHeader) + header.sectionCount * sizeof(MapSection));
+    sections[0].bytes = walls.size() * sizeof(uint64_t);
+    if (withTable) {
+        sections[1].type = static_cast<uint32_t>(MapSectionType::JpsPlus);
+        sections[1].offset = alignUp(sections[0].offset + sections[0].bytes);
+        sections[1].bytes = table->entryCount() * sizeof(int32_t);
+    }
+
+    ofstream out(path, ios::binary);
+    if (!out) return false;
+    const char zeros[SECTION_ALIGN] = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(sections), header.sectionCount * sizeof(MapSection));
+    size_t written = sizeof(header) + header.sectionCount * sizeof(MapSection);
+    out.write(zeros, sections[0].offset - written);
+    out.write(reinterpret_cast<const char*>(walls.data()), sections[0].bytes);
+    if (withTable) {
+        out.write(zeros, sections[1].offset - (sections[0].offset + sections[0].bytes));
+        out.write(reinterpret_cast<const char*>(table->data()), sections[1].bytes);
+    }
+    return static_cast<bool>(out);
+}
+
+bool importMovingAiMap(const string& path, Grid& grid) {
+    ifstream in(path, ios::binary);
+    if (!in) return false;
+    stringstream buffer;
+    buffer << in.rdbuf();
+    const string text = buffer.str();
+
+    // Header lines up to "map"; the type line is accepted whatever it says
+    size_t pos = 0;
+    int rows = -1, cols = -1;
+    for (;;) {
+        size_t end = text.find('\n', pos);
+        if (end == string::npos) return false;
+        string line = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line == "map") break;
+        if (line.compare(0, 7, "height ") == 0) rows = atoi(line.c_str() + 7);
+        else if (line.compare(0, 6, "width ") == 0) cols = atoi(line.c_str() + 6);
+    }
+    if (rows <= 0 || cols <= 0) return false;
+
+    grid.resize(rows, cols);
+    for (int x = 0; x < rows; ++x) {
+        if (pos + cols > text.size()) return false;
+        const char* line = text.data() + pos;
+        char* row = &grid.at(x, 0);
+        for (int y = 0; y < cols; ++y) {
+            char c = line[y];
+            row[y] = c == '.' || c == 'G' || c == 'S' ? PATH : WALL;
+        }
+        pos += cols;
+        while (pos < text.size() && (text[pos] == '\r' || text[pos] == '\n')) ++pos;
+    }
+    return true;
+}
+
+bool exportMovingAiMap(const string& path, const Grid& grid) {
+    ofstream out(path, ios::binary);
+    if (!out) return false;
+    out << "type octile\nheight " << grid.rows() << "\nwidth " << grid.cols() << "\nmap\n";
+    string line(grid.cols() + 1, '\n');
+    for (int x = 0; x < grid.rows(); ++x) {
+        for (int y = 0; y < grid.cols(); ++y) line[y] = grid.at(x, y) == WALL ? '@' : '.';
+        out.write(line.data(), line.size());
+    }
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Pathfinder.h"
+
+class JPSPlusTable;
+
+// Binary map format (".pfm"), little-endian:
+//   MapHeader
+//   MapSection[sectionCount]    where each section's bytes live (64-byte aligned offsets)
+//   section data
+// The Walls section is required: one bit per cell, set for walls, row by row with each
+// row padded to whole 64-bit words. Optional sections carry precomputed data that can be
+// used straight from the mapping, such as a JPS+ table built for the map.
+const std::uint32_t MAP_VERSION = 1;
+
+enum class MapSectionType : std::uint32_t {
+    Walls = 1,
+    JpsPlus = 2 // JPSPlusTable entries, DIRS_8 int32 per padded flat index
+};
+
+struct MapHeader {
+    char magic[4]; // "PFMP"
+    std::uint32_t version;
+    std::int32_t rows, cols;
+    std::int32_t startX, startY, goalX, goalY;
+    std::uint32_t sectionCount;
+    std::uint32_t reserved;
+};
+
+struct MapSection {
+    std::uint32_t type; // MapSectionType
+    std::uint32_t reserved;
+    std::uint64_t offset; // From the start of the file
+    std::uint64_t bytes;
+};
+
+// Read-only memory mapping of a .pfm file. Opening validates the header and section
+// bounds but copies nothing; pages are read from disk as they're touched.
+class MapFile {
+public:
+    MapFile() {}
+    ~MapFile() { close(); }
+    MapFile(const MapFile&) = delete;
+    MapFile& operator=(const MapFile&) = delete;
+
+    // Returns false (and leaves the object closed) if the file is missing or malformed
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    int rows() const { return header->rows; }
+    int cols() const { return header->cols; }
+    Point start() const { return Point(header->startX, header->startY); }
+    Point goal() const { return Point(header->goalX, header->goalY); }
+    std::size_t fileBytes() const { return size; }
+
+    int rowWords() const { return (cols() + 63) / 64; }
+    const std::uint64_t* wallRow(int x) const { return walls + static_cast<std::size_t>(x) * rowWords(); }
+    bool isWall(int x, int y) const { return (wallRow(x)[y >> 6] >> (y & 63)) & 1; }
+
+    // Bytes of an optional section, or nullptr if the file doesn't have one
+    const void* section(MapSectionType type, std::size_t& bytes) const;
+
+private:
+    const unsigned char* data = nullptr;
+    std::size_t size = 0;
+    const MapHeader* header = nullptr;
+    const std::uint64_t* walls = nullptr;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+// Expands the wall layer into grid, eight cells per table lookup, and marks START and END
+void loadGrid(const MapFile& file, Grid& grid);
+
+// Attaches the file's JPS+ section to table without copying. grid is the file's map as
+// read by loadGrid; false if the file has no section or its distances don't fit grid
+// (see JPSPlusTable::attach).
+bool attachJpsPlus(const MapFile& file, const Grid& grid, JPSPlusTable& table);
+
+// Writes grid as a .pfm file. Every cell that isn't WALL is stored as open. A table built
+// for grid is stored as the optional JpsPlus section.
+bool saveMap(const std::string& path, const Grid& grid, Point start, Point goal, const JPSPlusTable* table = nullptr);
+
+// Reads a MovingAI benchmark .map file ("type octile", "height H", "width W", "map", then
+// H rows of W terrain characters). '.', 'G' and 'S' are open; '@', 'O', 'T', 'W' and
+// anything else are walls. Returns false on a malformed file.
+bool importMovingAiMap(const std::string& path, Grid& grid);
+
+// Writes grid in the MovingAI text format (open cells as '.', walls as '@')
+bool exportMovingAiMap(const std::string& path, const Grid& grid);
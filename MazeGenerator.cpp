@@ -0,0 +1,420 @@
+#include "MazeGenerator.h"
+#include "Bits.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// The cells a carver connects sit at even grid coordinates and the walls between them at
+// odd ones. Lattice cells are numbered over a padded array, as in Grid, so a border of
+// marked cells replaces bounds checks on neighbours.
+struct Lattice {
+    int rows, cols, stride;
+    int offset[DIRS_4]; // Matches dx_4/dy_4 and Grid::offset4
+
+    Lattice(int rows, int cols, int stride) : rows(rows), cols(cols), stride(stride) {
+        for (int d = 0; d < DIRS_4; ++d) offset[d] = dx_4[d] * stride + dy_4[d];
+    }
+
+    int size() const { return (rows + 2) * stride; }
+    int cell(int i, int j) const { return (i + 1) * stride + (j + 1); }
+
+    // One byte per lattice cell: `inside` for the rows x cols cells, `border` elsewhere
+    vector<uint8_t> marks(uint8_t inside, uint8_t border) const {
+        vector<uint8_t> m(size(), border);
+        for (int i = 0; i < rows; ++i)
+            fill(m.begin() + cell(i, 0), m.begin() + cell(i, cols), inside);
+        return m;
+    }
+};
+
+// NTH_DIR[mask][k] is the k-th set bit of a 4-bit direction mask, so picking a random
+// candidate direction needs no branches on which neighbours qualified
+struct DirectionPicker {
+    int8_t nth[16][DIRS_4];
+    int8_t count[16];
+    DirectionPicker() {
+        for (int mask = 0; mask < 16; ++mask) {
+            count[mask] = 0;
+            for (int d = 0; d < DIRS_4; ++d)
+                if (mask & (1 << d)) nth[mask][count[mask]++] = static_cast<int8_t>(d);
+        }
+    }
+    int pick(int mask, Rng& rng) const {
+        int n = count[mask];
+        return nth[mask][n == 1 ? 0 : rng.below(n)];
+    }
+};
+static const DirectionPicker PICKER;
+
+// Bit d set where the low four bits of marks[c + offset[d]] equal value
+static int neighbourMask(const vector<uint8_t>& marks, const Lattice& lattice, int c, uint8_t value) {
+    auto is = [&](int d) { return (marks[c + lattice.offset[d]] & 0x0f) == value; };
+    return is(0) | is(1) << 1 | is(2) << 2 | is(3) << 3;
+}
+
+// Lattice rows per band of a maze (1024 grid rows)
+static const int BAND_ROWS = 512;
+
+// Writes a band carved on a compact lattice to grid rows 2 * i0 onwards, in one sequential
+// pass. Above the low four bits, each lattice byte holds the direction the carver entered
+// the cell in (bit DIRS_4 + d for dx_4/dy_4 direction d): the wall below a cell is down
+// if the cell was entered going up or the one below it going down, and likewise for the
+// wall to its right. The walls below the last row and right of the last column stay WALL
+// (border cells carry no direction), even where an odd number of grid rows or columns
+// puts them on the grid's border.
+static void writeBand(Grid& grid, int i0, const Lattice& lattice, const vector<uint8_t>& cells) {
+    const uint8_t UP = 0x10, DOWN = 0x20, LEFT = 0x40, RIGHT = 0x80;
+    for (int i = 0; i < lattice.rows; ++i) {
+        char* even = &grid[grid.index(2 * (i0 + i), 0)];
+        char* odd = &grid[grid.index(2 * (i0 + i) + 1, 0)];
+        const uint8_t* cell = &cells[lattice.cell(i, 0)];
+        const uint8_t* below = cell + lattice.stride;
+        for (int j = 0; j < lattice.cols; ++j) {
+            even[2 * j] = PATH;
+            even[2 * j + 1] = ((cell[j] & LEFT) | (cell[j + 1] & RIGHT)) ? PATH : WALL;
+            odd[2 * j] = ((cell[j] & UP) | (below[j] & DOWN)) ? PATH : WALL;
+        }
+    }
+}
+
+// Compact lattice of lattice rows [i0, i1) of grid
+static Lattice bandLattice(const Grid& grid, int i0, int i1) {
+    int cols = (grid.cols() + 1) / 2;
+    return Lattice(i1 - i0, cols, cols + 2);
+}
+
+// Randomized depth-first carving of lattice rows [i0, i1). A byte has its low four bits
+// set once the cell is seen, so testing a neighbour takes one AND, and its entry bits lead
+// back along the current branch: backtracking needs no stack, and the directions still
+// open are recomputed on the way back.
+static void carveBacktrackerBand(Grid& grid, int i0, int i1, Rng& rng) {
+    const uint8_t SEEN = (1 << DIRS_4) - 1; // Border cells and the first cell: no direction
+    Lattice lattice = bandLattice(grid, i0, i1);
+    vector<uint8_t> cells = lattice.marks(0, SEEN);
+    int back[1 << DIRS_4]; // Offset to the previous cell, by the entry bits
+    for (int d = 0; d < DIRS_4; ++d) back[1 << d] = -lattice.offset[d];
+    // Byte stores may alias anything, so the walk uses a local generator, raw pointers and
+    // local offsets to keep them out of memory
+    Rng walk = rng;
+    uint8_t* mark = cells.data();
+    const int up = lattice.offset[0], down = lattice.offset[1];
+    auto unseen = [&](const uint8_t* p) { return ~((p[up] & 1) | (p[down] & 2) | (p[-1] & 4) | (p[1] & 8)) & SEEN; };
+    uint8_t* c = mark + lattice.cell(0, 0);
+    *c = SEEN;
+
+    for (;;) {
+        int mask = unseen(c);
+        while (mask == 0 && *c != SEEN) {
+            c += back[*c >> DIRS_4];
+            mask = unseen(c);
+        }
+        if (mask == 0) break;
+
+        int d = PICKER.pick(mask, walk);
+        c += lattice.offset[d];
+        *c = static_cast<uint8_t>(SEEN | 1 << (DIRS_4 + d));
+    }
+    rng = walk;
+    writeBand(grid, i0, lattice, cells);
+}
+
+// Randomized Prim's on lattice rows [i0, i1): grows the maze from the band's first cell
+// by attaching a random frontier cell to a random neighbour that is already in the maze
+static void carvePrimBand(Grid& grid, int i0, int i1, Rng& rng) {
+    enum : uint8_t { UNSEEN, FRONTIER, IN_MAZE, BORDER }; // Low four bits; entry bits above
+    Lattice lattice = bandLattice(grid, i0, i1);
+    vector<uint8_t> cells = lattice.marks(UNSEEN, BORDER);
+    vector<int> frontier;
+
+    auto join = [&](int c, int entry) {
+        cells[c] = static_cast<uint8_t>(IN_MAZE | entry);
+        for (int d = 0; d < DIRS_4; ++d) {
+            int n = c + lattice.offset[d];
+            if (cells[n] == UNSEEN) {
+                cells[n] = FRONTIER;
+                frontier.push_back(n);
+            }
+        }
+    };
+
+    join(lattice.cell(0, 0), 0);
+    while (!frontier.empty()) {
+        size_t k = rng.below(static_cast<uint32_t>(frontier.size()));
+        int c = frontier[k];
+        frontier[k] = frontier.back();
+        frontier.pop_back();
+
+        // Attaching to the neighbour in direction d enters c going the opposite way (d ^ 1)
+        int d = PICKER.pick(neighbourMask(cells, lattice, c, IN_MAZE), rng);
+        join(c, 1 << (DIRS_4 + (d ^ 1)));
+    }
+    writeBand(grid, i0, lattice, cells);
+}
+
+// Uniform shuffle that stays cache-friendly on arrays far larger than the cache: scatter
+// the items into 256 random buckets (sequential writes), then Fisher-Yates each bucket
+// in place (Rao-Sandelius)
+static void shuffleLarge(vector<int>& items, Rng& rng) {
+    const int BUCKETS = 256;
+    if (items.size() < (1u << 16)) {
+        for (size_t k = items.size(); k > 1; --k)
+            swap(items[k - 1], items[rng.below(static_cast<uint32_t>(k))]);
+        return;
+    }
+
+    vector<uint8_t> bucketOf(items.size());
+    for (size_t i = 0; i < items.size(); i += 8) {
+        uint64_t bits = rng.next();
+        for (size_t k = i; k < i + 8 && k < items.size(); ++k, bits >>= 8) bucketOf[k] = static_cast<uint8_t>(bits);
+    }
+    size_t start[BUCKETS + 1] = {};
+    for (uint8_t b : bucketOf) ++start[b + 1];
+    for (int b = 0; b < BUCKETS; ++b) start[b + 1] += start[b];
+
+    vector<int> scattered(items.size());
+    size_t fillAt[BUCKETS];
+    copy(start, start + BUCKETS, fillAt);
+    for (size_t i = 0; i < items.size(); ++i) scattered[fillAt[bucketOf[i]]++] = items[i];
+
+    for (int b = 0; b < BUCKETS; ++b) {
+        int* first = &scattered[0] + start[b];
+        for (size_t k = start[b + 1] - start[b]; k > 1; --k)
+            swap(first[k - 1], first[rng.below(static_cast<uint32_t>(k))]);
+    }
+    items.swap(scattered);
+}
+
+// Randomized Kruskal's on lattice rows [i0, i1): knocks down the walls between lattice
+// cells in shuffled order whenever the two sides are not yet connected (union-find by
+// size with path halving). The shuffled order makes nearly every find a cache miss, so
+// the parents of the walls a few places ahead are prefetched.
+static void carveKruskalBand(Grid& grid, int i0, int i1, Rng& rng) {
+    const int DOWN = 1, RIGHT = 3; // Indices into dx_4/dy_4
+    Lattice lattice = bandLattice(grid, i0, i1);
+    vector<int> edges; // cell * 2 + (0 for the wall below, 1 for the wall to the right)
+    edges.reserve(static_cast<size_t>(lattice.rows) * lattice.cols * 2);
+    for (int i = 0; i < lattice.rows; ++i) {
+        for (int j = 0; j < lattice.cols; ++j) {
+            int c = lattice.cell(i, j);
+            if (i + 1 < lattice.rows) edges.push_back(c * 2);
+            if (j + 1 < lattice.cols) edges.push_back(c * 2 + 1);
+        }
+    }
+    shuffleLarge(edges, rng);
+
+    vector<int> parent(lattice.size(), -1); // Negative: root of a set of -parent cells
+    auto find = [&](int c) {
+        while (parent[c] >= 0) {
+            int up = parent[c];
+            if (parent[up] >= 0) parent[c] = parent[up];
+            c = up;
+        }
+        return c;
+    };
+
+    vector<uint8_t> cells(lattice.size(), 0); // Entry bits only, for writeBand
+    const size_t AHEAD = 16;
+    for (size_t k = 0; k < edges.size(); ++k) {
+        if (k + AHEAD < edges.size()) {
+            int f = edges[k + AHEAD];
+            prefetch(&parent[f >> 1]);
+            prefetch(&parent[(f >> 1) + lattice.offset[(f & 1) ? RIGHT : DOWN]]);
+        }
+        int e = edges[k];
+        int c = e >> 1;
+        int d = (e & 1) ? RIGHT : DOWN;
+        int a = find(c), b = find(c + lattice.offset[d]);
+        if (a == b) continue;
+        if (parent[a] > parent[b]) swap(a, b); // a is the larger set
+        parent[a] += parent[b];
+        parent[b] = a;
+        cells[c + lattice.offset[d]] |= static_cast<uint8_t>(1 << (DIRS_4 + d));
+    }
+    writeBand(grid, i0, lattice, cells);
+}
+
+// Mazes taller than one band are carved band by band on worker threads, each band as its
+// own maze from its own generator seeded in order from rng so the maze doesn't depend on
+// the thread count, then joined through one random opening in the wall row between
+// neighbouring bands, which keeps the maze a spanning tree. A single band is carved
+// straight from rng.
+typedef void (*BandCarver)(Grid& grid, int i0, int i1, Rng& rng);
+static void carveInBands(Grid& grid, BandCarver carve, Rng& rng, int threads) {
+    int rows = (grid.rows() + 1) / 2, cols = (grid.cols() + 1) / 2;
+    int bands = (rows + BAND_ROWS - 1) / BAND_ROWS;
+    if (bands == 1) {
+        carve(grid, 0, rows, rng);
+        return;
+    }
+
+    vector<uint64_t> seeds(bands);
+    for (uint64_t& seed : seeds) seed = rng.next();
+    int count = min(threads > 0 ? threads : defaultThreadCount(), bands);
+    parallelFor(bands, count, [&](int b, int) {
+        Rng band(seeds[b]);
+        carve(grid, b * BAND_ROWS, min(rows, (b + 1) * BAND_ROWS), band);
+    });
+    for (int b = 1; b < bands; ++b) grid.at(2 * b * BAND_ROWS - 1, 2 * static_cast<int>(rng.below(cols))) = PATH;
+}
+
+// Turns each wall in rows [r0, r1) x cols [c0, c1) into a path with `percent`% chance.
+// Every cell consumes one 16-bit roll, four per 64-bit draw. The outcome is unpredictable
+// by design, so the four cells of a draw are updated at once without branches: roll r is
+// below threshold t exactly when bit 16 of r + (0x10000 - t) is clear, computed for two
+// rolls per 64-bit add, and a cell is a wall exactly when its byte XOR WALL is zero.
+static void knockOutRows(Grid& grid, int r0, int r1, int c0, int c1, int percent, Rng& rng) {
+    uint32_t threshold = percent >= 100 ? 0x10000 : static_cast<uint32_t>(percent) * 0x10000 / 100;
+    const uint64_t LANES = 0x0000ffff0000ffffULL;
+    const uint64_t bias = (0x10000 - threshold) * 0x0000000100000001ULL;
+    const uint32_t ONES = 0x01010101u;
+    Rng rolls = rng; // Kept out of memory, as in carveBacktrackerBand
+    for (int i = r0; i < r1; ++i) {
+        unsigned char* row = reinterpret_cast<unsigned char*>(&grid.at(i, 0));
+        int j = c0;
+        for (; j + 4 <= c1; j += 4) {
+            uint64_t bits = rolls.next();
+            uint64_t even = ~((bits & LANES) + bias), odd = ~((bits >> 16 & LANES) + bias);
+            uint32_t below = static_cast<uint32_t>((even >> 16 & 1) | (odd >> 8 & 0x100) | (even >> 32 & 0x10000) |
+                (odd >> 24 & 0x1000000));
+            uint32_t cells = row[j] | row[j + 1] << 8 | row[j + 2] << 16 | static_cast<uint32_t>(row[j + 3]) << 24;
+            uint32_t v = cells ^ ONES * static_cast<unsigned char>(WALL);
+            uint32_t wall = ~(((v & 0x7f7f7f7fu) + 0x7f7f7f7fu) | v) >> 7 & ONES;
+            cells ^= (below & wall) * static_cast<unsigned char>(WALL ^ PATH);
+            row[j] = static_cast<unsigned char>(cells);
+            row[j + 1] = static_cast<unsigned char>(cells >> 8);
+            row[j + 2] = static_cast<unsigned char>(cells >> 16);
+            row[j + 3] = static_cast<unsigned char>(cells >> 24);
+        }
+        if (j < c1) {
+            uint64_t bits = rolls.next();
+            for (int k = j; k < c1; ++k, bits >>= 16) {
+                unsigned char c = row[k];
+                int open = (static_cast<uint32_t>(bits & 0xffff) < threshold) & (c == static_cast<unsigned char>(WALL));
+                row[k] = static_cast<unsigned char>(c ^ (-open & (WALL ^ PATH)));
+            }
+        }
+    }
+    rng = rolls;
+}
+
+// knockOutRows over a whole region. Regions taller than one band of rows are split into
+// bands rolled on worker threads, each from its own generator seeded in order from rng,
+// so the result doesn't depend on the thread count.
+static void knockOutWalls(Grid& grid, int r0, int r1, int c0, int c1, int percent, Rng& rng, int threads) {
+    const int bandGridRows = 2 * BAND_ROWS;
+    if (percent <= 0 || r0 >= r1 || c0 >= c1) return;
+    if (r1 - r0 <= bandGridRows) {
+        knockOutRows(grid, r0, r1, c0, c1, percent, rng);
+        return;
+    }
+
+    int bands = (r1 - r0 + bandGridRows - 1) / bandGridRows;
+    vector<uint64_t> seeds(bands);
+    for (uint64_t& seed : seeds) seed = rng.next();
+    parallelFor(bands, min(threads > 0 ? threads : defaultThreadCount(), bands), [&](int b, int) {
+        Rng band(seeds[b]);
+        knockOutRows(grid, r0 + b * bandGridRows, min(r1, r0 + (b + 1) * bandGridRows), c0, c1, percent, band);
+    });
+}
+
+// Opens a random monotone staircase from (0, 0) to (rows - 1, cols - 1), so an open
+// field is solvable at any obstacle density
+static void carveStaircase(Grid& grid, Rng& rng) {
+    int x = 0, y = 0;
+    grid.at(x, y) = PATH;
+    while (x < grid.rows() - 1 || y < grid.cols() - 1) {
+        uint32_t down = grid.rows() - 1 - x, right = grid.cols() - 1 - y;
+        if (rng.below(down + right) < down) ++x;
+        else ++y;
+        grid.at(x, y) = PATH;
+    }
+}
+
+void generateMaze(Grid& grid, const MazeOptions& options) {
+    int rows = options.rows, cols = options.cols;
+    initializeGrid(grid, rows, cols);
+    Rng rng(options.seed);
+    Point start(0, 0);
+    Point endpoint(rows - 1, cols - 1);
+
+    if (options.algorithm == MazeAlgorithm::OpenField) {
+        knockOutWalls(grid, 0, rows, 0, cols, options.knockoutPercent, rng, options.threads);
+        carveStaircase(grid, rng);
+        grid.at(start.x, start.y) = START;
+        grid.at(endpoint.x, endpoint.y) = END;
+        return;
+    }
+
+    BandCarver carve = carveBacktrackerBand;
+    if (options.algorithm == MazeAlgorithm::Prim) carve = carvePrimBand;
+    else if (options.algorithm == MazeAlgorithm::Kruskal) carve = carveKruskalBand;
+    carveInBands(grid, carve, rng, options.threads);
+
+    // Ensure start and end points are paths
+    grid.at(start.x, start.y) = START;
+    grid.at(endpoint.x, endpoint.y) = END;
+
+    // Also ensure neighbors of endpoint are path if they were walls, to aid reachability
+    if (endpoint.x > 0 && grid.at(endpoint.x - 1, endpoint.y) == WALL) grid.at(endpoint.x - 1, endpoint.y) = PATH;
+    if (endpoint.y > 0 && grid.at(endpoint.x, endpoint.y - 1) == WALL) grid.at(endpoint.x, endpoint.y - 1) = PATH;
+
+    // Add some random paths to make the maze less sparse and more interesting
+    knockOutWalls(grid, 1, rows - 1, 1, cols - 1, options.knockoutPercent, rng, options.threads);
+
+    // Re-set start and end points after random path additions
+    grid.at(start.x, start.y) = START;
+    grid.at(endpoint.x, endpoint.y) = END;
+}
+
+void guaranteeSolvableMaze(Grid& grid, int rows, int cols, uint64_t seed) {
+    MazeOptions options;
+    options.seed = seed;
+    options.rows = rows;
+    options.cols = cols;
+    generateMaze(grid, options);
+}
+
+static const char* const ALGORITHM_NAMES[] = { "backtracker", "prim", "kruskal", "open" };
+
+const char* mazeAlgorithmName(MazeAlgorithm algorithm) {
+    return ALGORITHM_NAMES[static_cast<int>(algorithm)];
+}
+
+bool parseMazeAlgorithm(const string& name, MazeAlgorithm& algorithm) {
+    for (int i = 0; i < 4; ++i) {
+        if (name == ALGORITHM_NAMES[i]) {
+            algorithm = static_cast<MazeAlgorithm>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool buildMap(Grid& grid, const string& spec, int rows, int cols, unsigned seed) {
+    MazeOptions options;
+    options.seed = seed;
+    options.rows = rows;
+    options.cols = cols;
+    size_t colon = spec.find(':');
+    string name = spec.substr(0, colon);
+    int value = colon == string::npos ? -1 : atoi(spec.c_str() + colon + 1);
+
+    if (name == "random") {
+        options.algorithm = MazeAlgorithm::OpenField;
+        options.knockoutPercent = 100 - max(0, value);
+    }
+    else if (name == "maze" || parseMazeAlgorithm(name, options.algorithm)) {
+        if (value >= 0) options.knockoutPercent = value;
+    }
+    else {
+        return false;
+    }
+    generateMaze(grid, options);
+    return true;
+}
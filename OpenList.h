@@ -0,0 +1,232 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "Bits.h"
+
+// Open-list policies for the best-first solvers (BFS, Dijkstra, A*, JPS).
+//
+// Every policy has the same interface:
+//   clear(cells)     prepare for a query over flat indices [0, cells); keeps capacity
+//   empty()          true when no entries are left
+//   push(key, cell)  insert cell with priority key (or lower its key, for decrease-key policies)
+//   pop()            remove and return a cell with the smallest key
+//
+// Lazy-deletion policies may return a cell more than once; solvers skip entries whose
+// node is already closed. Keys must be non-negative, and the bucket and radix queues
+// additionally need them to be monotone (never below the last key popped), which holds
+// for Dijkstra and for A*/JPS with the consistent heuristics used here.
+// MonotoneKeys<OpenList> tells which policies need it.
+
+// Binary min-heap with lazy deletion; ties go to the smaller flat index. The same
+// push_heap/pop_heap steps as std::priority_queue, over a vector that clear() keeps.
+class BinaryHeapOpenList {
+public:
+    void clear(int) { heap.clear(); }
+    bool empty() const { return heap.empty(); }
+    void push(int key, int cell) {
+        heap.push_back({ key, cell });
+        std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+    }
+    int pop() {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+        int cell = heap.back().second;
+        heap.pop_back();
+        return cell;
+    }
+
+private:
+    typedef std::pair<int, int> Entry; // (key, cell)
+    std::vector<Entry> heap;
+};
+
+// Dial's bucket queue: one bucket per key in a ring that doubles when a key lands
+// beyond its span. Push and pop are O(1) amortized; ties pop in LIFO order.
+class BucketQueue {
+public:
+    void clear(int) {
+        for (std::vector<int>& b : buckets) b.clear();
+        if (buckets.empty()) buckets.resize(64);
+        cursor = -1;
+        count = 0;
+    }
+    bool empty() const { return count == 0; }
+    void push(int key, int cell) {
+        if (cursor < 0) cursor = key; // First push after clear() anchors the ring
+        while (static_cast<size_t>(key - cursor) >= buckets.size()) grow();
+        buckets[key & mask()].push_back(cell);
+        ++count;
+    }
+    int pop() {
+        while (buckets[cursor & mask()].empty()) ++cursor;
+        std::vector<int>& b = buckets[cursor & mask()];
+        int cell = b.back();
+        b.pop_back();
+        --count;
+        return cell;
+    }
+
+private:
+    size_t mask() const { return buckets.size() - 1; }
+    // Doubles the ring, re-placing entries by their key (recoverable from slot and cursor)
+    void grow() {
+        std::vector<std::vector<int>> bigger(buckets.size() * 2);
+        size_t bigMask = bigger.size() - 1;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            int key = cursor + static_cast<int>((i - cursor) & mask());
+            for (int cell : buckets[i]) bigger[key & bigMask].push_back(cell);
+        }
+        buckets.swap(bigger);
+    }
+
+    std::vector<std::vector<int>> buckets; // size is a power of two
+    int cursor = -1;                       // no entry has a smaller key; -1 until the first push
+    size_t count = 0;
+};
+
+// Monotone radix heap: entries sit in the bucket of the highest bit in which their key
+// differs from the last popped key, so each entry is redistributed at most 32 times.
+class RadixHeap {
+public:
+    void clear(int) {
+        for (std::vector<Entry>& b : buckets) b.clear();
+        last = 0;
+        count = 0;
+    }
+    bool empty() const { return count == 0; }
+    void push(int key, int cell) {
+        buckets[bucketFor(static_cast<unsigned>(key))].push_back({ static_cast<unsigned>(key), cell });
+        ++count;
+    }
+    int pop() {
+        if (buckets[0].empty()) {
+            int i = 1;
+            while (buckets[i].empty()) ++i;
+            // The new minimum comes from the first non-empty bucket; spread it out around that key
+            unsigned smallest = buckets[i][0].first;
+            for (const Entry& e : buckets[i])
+                if (e.first < smallest) smallest = e.first;
+            last = smallest;
+            for (const Entry& e : buckets[i]) buckets[bucketFor(e.first)].push_back(e);
+            buckets[i].clear();
+        }
+        int cell = buckets[0].back().second;
+        buckets[0].pop_back();
+        --count;
+        return cell;
+    }
+
+private:
+    typedef std::pair<unsigned, int> Entry; // (key, cell)
+    int bucketFor(unsigned key) const { return key == last ? 0 : highestBit(key ^ last) + 1; }
+
+    std::vector<Entry> buckets[33];
+    unsigned last = 0;
+    size_t count = 0;
+};
+
+// Indexed D-ary heap with decrease-key: each cell is in the heap at most once, so pops
+// are never stale. Ties go to the smaller flat index, as in BinaryHeapOpenList.
+template <int D>
+class DaryHeap {
+public:
+    void clear(int cells) {
+        if (pos.size() != static_cast<size_t>(cells)) pos.assign(cells, -1);
+        else for (const Entry& e : heap) pos[e.second] = -1;
+        heap.clear();
+    }
+    bool empty() const { return heap.empty(); }
+    void push(int key, int cell) {
+        int i = pos[cell];
+        if (i < 0) {
+            i = static_cast<int>(heap.size());
+            heap.push_back({ key, cell });
+        }
+        else if (key < heap[i].first) {
+            heap[i].first = key;
+        }
+        else {
+            return;
+        }
+        siftUp(i);
+    }
+    int pop() {
+        int cell = heap[0].second;
+        pos[cell] = -1;
+        Entry last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            pos[last.second] = 0;
+            siftDown(0);
+        }
+        return cell;
+    }
+
+private:
+    typedef std::pair<int, int> Entry; // (key, cell)
+
+    void place(int i, const Entry& e) {
+        heap[i] = e;
+        pos[e.second] = i;
+    }
+    void siftUp(int i) {
+        Entry e = heap[i];
+        while (i > 0) {
+            int up = (i - 1) / D;
+            if (!(e < heap[up])) break;
+            place(i, heap[up]);
+            i = up;
+        }
+        place(i, e);
+    }
+    void siftDown(int i) {
+        Entry e = heap[i];
+        int n = static_cast<int>(heap.size());
+        for (;;) {
+            int first = i * D + 1;
+            if (first >= n) break;
+            int best = first;
+            int end = first + D < n ? first + D : n;
+            for (int c = first + 1; c < end; ++c)
+                if (heap[c] < heap[best]) best = c;
+            if (!(heap[best] < e)) break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, e);
+    }
+
+    std::vector<Entry> heap;
+    std::vector<int> pos; // heap slot of each cell, -1 if absent
+};
+
+typedef DaryHeap<4> QuaternaryHeap;
+
+// FIFO queue that ignores keys: with unit costs and no heuristic the best-first loop
+// becomes BFS. Storage is a vector consumed from the front and reused across queries.
+class FifoQueue {
+public:
+    void clear(int) {
+        cells.clear();
+        head = 0;
+    }
+    bool empty() const { return head == cells.size(); }
+    void push(int, int cell) { cells.push_back(cell); }
+    int pop() { return cells[head++]; }
+
+private:
+    std::vector<int> cells;
+    size_t head = 0;
+};
+
+// True for the policies whose keys must never drop below the last key popped
+template <class OpenList>
+struct MonotoneKeys { static constexpr bool value = false; };
+template <>
+struct MonotoneKeys<BucketQueue> { static constexpr bool value = true; };
+template <>
+struct MonotoneKeys<RadixHeap> { static constexpr bool value = true; };
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Number of worker threads to use when the caller doesn't ask for a specific count
+inline int defaultThreadCount() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? static_cast<int>(n) : 1;
+}
+
+// Runs fn(i, worker) for every i in [0, count) on `threads` workers. Work is handed
+// out one index at a time from a shared counter, so uneven item costs balance out.
+// worker is in [0, threads) and lets callers keep per-thread state such as a SearchContext.
+template <class Fn>
+void parallelFor(int count, int threads, Fn fn) {
+    std::atomic<int> next(0);
+    auto work = [&](int worker) {
+        for (int i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+            fn(i, worker);
+    };
+    if (threads <= 1) {
+        work(0);
+        return;
+    }
+
+    std::vector<std::thread> pool;
+    for (int w = 1; w < threads; ++w) pool.emplace_back(work, w);
+    work(0);
+    for (std::thread& t : pool) t.join();
+}
+
+// Fixed set of threads that run one job together, for algorithms made of many short
+// parallel phases where starting threads per phase would cost more than the phase.
+// The calling thread takes part as worker 0.
+class WorkerPool {
+public:
+    explicit WorkerPool(int threads = defaultThreadCount()) : size_(threads > 1 ? threads : 1) {
+        for (int w = 1; w < size_; ++w) pool.emplace_back([this, w] { loop(w); });
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (std::thread& t : pool) t.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int size() const { return size_; }
+
+    // Runs fn(worker) once on every worker and returns when all of them have finished
+    template <class Fn>
+    void run(Fn fn) {
+        if (size_ == 1) {
+            fn(0);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = std::ref(fn);
+            pending = size_ - 1;
+            ++generation;
+        }
+        wake.notify_all();
+        fn(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return pending == 0; });
+        job = nullptr;
+    }
+
+private:
+    void loop(int worker) {
+        unsigned seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stop || generation != seen; });
+                if (stop) return;
+                seen = generation;
+            }
+            job(worker);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) done.notify_one();
+        }
+    }
+
+    int size_;
+    std::vector<std::thread> pool;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    std::function<void(int)> job;
+    unsigned generation = 0;
+    int pending = 0;
+    bool stop = false;
+};
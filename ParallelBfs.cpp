@@ -0,0 +1,216 @@
+#include "ParallelBfs.h"
+#include "Bits.h"
+
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+// Bit positions are flat grid indices plus one word, so the up-neighbour reads of the
+// first row never go negative
+static const int PAD = 64;
+// Frontier cells handed out per claim in a top-down level, bitmap words in a bottom-up one
+static const int CELL_CHUNK = 256;
+static const int WORD_CHUNK = 512;
+// Levels with less work than this run on the calling thread; waking the pool costs more
+static const int PARALLEL_MIN_CELLS = 2048;
+static const int PARALLEL_MIN_WORDS = 8192;
+// A top-down frontier cell costs about as much as this many bottom-up words (four scattered
+// reads and claims against a few shifts and ORs per word). Grid frontiers are thin bands,
+// so bottom-up only wins on narrow maps; higher values made open 300-wide fields slower.
+static const int TOP_DOWN_COST = 3;
+
+static bool testBit(const uint64_t* bits, int idx) {
+    int p = idx + PAD;
+    return (bits[p >> 6] >> (p & 63)) & 1;
+}
+
+// The 64 bits starting at bit position p
+static uint64_t bitsAt(const uint64_t* bits, size_t p) {
+    size_t q = p >> 6;
+    int r = static_cast<int>(p & 63);
+    return r ? (bits[q] >> r) | (bits[q + 1] << (64 - r)) : bits[q];
+}
+
+void ParallelBfs::build(const Grid& grid) {
+    rows_ = grid.rows();
+    cols_ = grid.cols();
+    stride = grid.stride();
+    // Two spare words past the last cell for the down-neighbour reads of the last row
+    words = (static_cast<size_t>(grid.size()) + PAD) / 64 + 3;
+    walls.assign(words, ~0ULL);
+    for (int idx = 0; idx < grid.size(); ++idx)
+        if (grid.isValid(idx)) walls[(idx + PAD) >> 6] &= ~(1ULL << ((idx + PAD) & 63));
+
+    visited.reset(new atomic<uint64_t>[words]);
+    for (vector<uint64_t>& bits : frontierBits) bits.assign(words, 0);
+    for (vector<WorkerCells>& list : lists) list.assign(pool.size(), WorkerCells());
+}
+
+bool ParallelBfs::search(SearchContext& ctx, bool stopAtGoal) {
+    ctx.reset();
+    bottomUp = 0;
+    const Grid& grid = *ctx.grid;
+    const unsigned epoch = ctx.epoch;
+    NodeState* nodes = ctx.nodes.data();
+    int s = grid.index(ctx.start.x, ctx.start.y);
+    int t = grid.index(ctx.goal.x, ctx.goal.y);
+    const int firstWord = (grid.index(0, 0) + PAD) >> 6;
+    const int lastWord = (grid.index(rows_ - 1, cols_ - 1) + PAD) >> 6;
+
+    for (size_t w = 0; w < words; ++w) visited[w].store(walls[w], memory_order_relaxed);
+    visited[(s + PAD) >> 6].fetch_or(1ULL << ((s + PAD) & 63), memory_order_relaxed);
+    nodes[s] = NodeState{ 0, s, epoch, true };
+
+    vector<WorkerCells>* cur = &lists[0];
+    vector<WorkerCells>* next = &lists[1];
+    for (WorkerCells& l : *cur) {
+        l.cells.clear();
+        l.lo = INT_MAX;
+        l.hi = -1;
+    }
+    (*cur)[0].cells.push_back(s);
+    (*cur)[0].lo = (*cur)[0].hi = s;
+
+    // Bottom-up state: frontierBits[fb] holds the current frontier, and dirty[b] is the word
+    // range of frontierBits[b] that may still hold set bits from earlier levels
+    bool bitmapMode = false;
+    int fb = 0;
+    int dirty[2][2] = { { 0, -1 }, { 0, -1 } };
+    vector<int> offsets(pool.size() + 1);
+    atomic<int> chunk(0);
+
+    for (int level = 0;; ++level) {
+        if (stopAtGoal && ctx.touched(t)) break;
+
+        int count = 0, lo = INT_MAX, hi = -1;
+        for (int w = 0; w < pool.size(); ++w) {
+            const WorkerCells& l = (*cur)[w];
+            offsets[w] = count;
+            count += static_cast<int>(l.cells.size());
+            lo = min(lo, l.lo);
+            hi = max(hi, l.hi);
+        }
+        offsets[pool.size()] = count;
+        if (count == 0) break;
+        ctx.stats.nodesExplored += count;
+        ctx.stats.pops += count;
+
+        for (WorkerCells& l : *next) {
+            l.cells.clear();
+            l.lo = INT_MAX;
+            l.hi = -1;
+        }
+
+        // Words a bottom-up step would scan: every cell within one step of the frontier
+        int first = max(firstWord, (lo - stride - 1 + PAD) >> 6);
+        int last = min(lastWord, (hi + stride + 1 + PAD) >> 6);
+        if (static_cast<long long>(count) * TOP_DOWN_COST > last - first + 1) {
+            if (!bitmapMode) {
+                for (const WorkerCells& l : *cur)
+                    for (int idx : l.cells) frontierBits[fb][(idx + PAD) >> 6] |= 1ULL << ((idx + PAD) & 63);
+                dirty[fb][0] = (lo + PAD) >> 6;
+                dirty[fb][1] = (hi + PAD) >> 6;
+                bitmapMode = true;
+            }
+            // Rewriting the target's dirty range as well clears the bits left from two levels ago
+            int nb = 1 - fb;
+            if (dirty[nb][0] <= dirty[nb][1]) {
+                first = min(first, dirty[nb][0]);
+                last = max(last, dirty[nb][1]);
+            }
+            const uint64_t* front = frontierBits[fb].data();
+            uint64_t* found = frontierBits[nb].data();
+
+            chunk = first;
+            auto step = [&](int worker) {
+                WorkerCells& out = (*next)[worker];
+                for (int c = chunk.fetch_add(WORD_CHUNK); c <= last; c = chunk.fetch_add(WORD_CHUNK)) {
+                    int end = min(c + WORD_CHUNK - 1, last);
+                    for (int w = c; w <= end; ++w) {
+                        size_t base = static_cast<size_t>(w) * 64;
+                        uint64_t seen = visited[w].load(memory_order_relaxed);
+                        uint64_t fresh = (bitsAt(front, base - 1) | bitsAt(front, base + 1) |
+                            bitsAt(front, base - stride) | bitsAt(front, base + stride)) & ~seen;
+                        found[w] = fresh;
+                        if (!fresh) continue;
+                        visited[w].store(seen | fresh, memory_order_relaxed);
+                        for (; fresh; fresh &= fresh - 1) {
+                            int idx = static_cast<int>(base + lowestBit(fresh)) - PAD;
+                            int d = 0;
+                            while (!testBit(front, idx + grid.offset4[d])) ++d;
+                            nodes[idx] = NodeState{ level + 1, idx + grid.offset4[d], epoch, true };
+                            out.cells.push_back(idx);
+                            out.lo = min(out.lo, idx);
+                            out.hi = max(out.hi, idx);
+                        }
+                    }
+                }
+            };
+            if (last - first + 1 < PARALLEL_MIN_WORDS) step(0);
+            else pool.run(step);
+
+            // The words written now hold exactly the cells just discovered
+            dirty[nb][0] = INT_MAX;
+            dirty[nb][1] = -1;
+            for (const WorkerCells& l : *next) {
+                if (l.cells.empty()) continue;
+                dirty[nb][0] = min(dirty[nb][0], (l.lo + PAD) >> 6);
+                dirty[nb][1] = max(dirty[nb][1], (l.hi + PAD) >> 6);
+            }
+            fb = nb;
+            ++bottomUp;
+        }
+        else {
+            if (bitmapMode) {
+                for (int b = 0; b < 2; ++b) {
+                    if (dirty[b][0] <= dirty[b][1])
+                        fill(frontierBits[b].begin() + dirty[b][0], frontierBits[b].begin() + dirty[b][1] + 1, 0);
+                    dirty[b][0] = 0;
+                    dirty[b][1] = -1;
+                }
+                bitmapMode = false;
+            }
+
+            chunk = 0;
+            bool alone = count < PARALLEL_MIN_CELLS || pool.size() == 1;
+            auto step = [&](int worker) {
+                WorkerCells& out = (*next)[worker];
+                for (int c = chunk.fetch_add(CELL_CHUNK); c < count; c = chunk.fetch_add(CELL_CHUNK)) {
+                    int end = min(c + CELL_CHUNK, count);
+                    int k = 0;
+                    for (int p = c; p < end; ++p) {
+                        while (offsets[k + 1] <= p) ++k;
+                        int curr = (*cur)[k].cells[p - offsets[k]];
+                        for (int d = 0; d < DIRS_4; ++d) {
+                            int n = curr + grid.offset4[d];
+                            uint64_t bit = 1ULL << ((n + PAD) & 63);
+                            atomic<uint64_t>& word = visited[(n + PAD) >> 6];
+                            // Plain read first: most neighbours are already taken. The
+                            // atomic claim is only needed when other workers are running.
+                            uint64_t seen = word.load(memory_order_relaxed);
+                            if (seen & bit) continue;
+                            if (alone) word.store(seen | bit, memory_order_relaxed);
+                            else if (word.fetch_or(bit, memory_order_relaxed) & bit) continue;
+                            nodes[n] = NodeState{ level + 1, curr, epoch, true };
+                            out.cells.push_back(n);
+                            out.lo = min(out.lo, n);
+                            out.hi = max(out.hi, n);
+                        }
+                    }
+                }
+            };
+            if (alone) step(0);
+            else pool.run(step);
+        }
+
+        for (const WorkerCells& l : *next) ctx.stats.pushes += static_cast<int>(l.cells.size());
+        swap(cur, next);
+    }
+
+    // Leave both frontier bitmaps clear for the next search
+    for (int b = 0; b < 2; ++b)
+        if (dirty[b][0] <= dirty[b][1])
+            fill(frontierBits[b].begin() + dirty[b][0], frontierBits[b].begin() + dirty[b][1] + 1, 0);
+    return ctx.touched(t);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Pathfinder.h"
+#include "Parallel.h"
+
+// Level-synchronous breadth-first search that splits every frontier across a WorkerPool,
+// for single-source searches on grids too large for one core. Each level runs in one of
+// two directions, whichever is estimated to be cheaper:
+//   top-down   frontier cells claim their unvisited neighbours in an atomic visited bitmap
+//   bottom-up  unvisited cells near the frontier look for a neighbour in the frontier
+//              bitmap, 64 cells per word with shifts and ORs
+// Like bfs, a search leaves a shortest-path parent tree rooted at ctx.start in ctx.nodes,
+// with the BFS distance in g. Which of several equally short parents a cell gets can
+// depend on thread timing; the distances cannot.
+class ParallelBfs {
+public:
+    explicit ParallelBfs(int threads = defaultThreadCount()) : pool(threads) {}
+
+    // Wall bitmap and scratch space for grid; call again whenever the grid changes
+    void build(const Grid& grid);
+
+    // Searches from ctx.start on the grid passed to build(). With stopAtGoal the search ends
+    // with the level that reaches ctx.goal, otherwise it labels every reachable cell.
+    // Returns true if the goal was reached.
+    bool search(SearchContext& ctx, bool stopAtGoal = true);
+
+    int threads() const { return pool.size(); }
+    // Levels of the last search that ran bottom-up
+    int bottomUpLevels() const { return bottomUp; }
+    bool matches(const Grid& grid) const { return rows_ == grid.rows() && cols_ == grid.cols(); }
+    size_t memoryBytes() const { return words * sizeof(std::uint64_t) * 4; }
+
+private:
+    // Cells one worker discovered in one level, padded so workers don't share a cache line
+    struct alignas(64) WorkerCells {
+        std::vector<int> cells;
+        int lo, hi; // Smallest and largest flat index in cells
+    };
+
+    WorkerPool pool;
+    int rows_ = 0, cols_ = 0, stride = 0;
+    size_t words = 0;
+    std::vector<std::uint64_t> walls;                 // Set for walls, the border and padding
+    std::unique_ptr<std::atomic<std::uint64_t>[]> visited;
+    std::vector<std::uint64_t> frontierBits[2];       // Current and next bottom-up frontier
+    std::vector<WorkerCells> lists[2];                // Current and next frontier, per worker
+    int bottomUp = 0;
+};
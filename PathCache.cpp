@@ -0,0 +1,161 @@
+#include "PathCache.h"
+
+#include <functional>
+
+using namespace std;
+
+// Cached paths from the same start (or to the same goal) scanned per sub-path lookup
+static const int MAX_SUBPATH_CANDIDATES = 16;
+
+size_t PathCache::KeyHash::operator()(const Key& k) const {
+    size_t h = hash<const void*>()(reinterpret_cast<const void*>(k.solve));
+    h ^= (static_cast<size_t>(static_cast<unsigned>(k.a)) * 0x9e3779b97f4a7c15ULL) + (h << 6) + (h >> 2);
+    return h ^ ((static_cast<size_t>(static_cast<unsigned>(k.b)) * 0xc2b2ae3d27d4eb4fULL) + (h << 6) + (h >> 2));
+}
+
+// Empties the cache when the grid was edited (or resized) since the entries were stored
+void PathCache::syncVersion() {
+    if (synced && version == grid.version()) return;
+    if (!lru.empty()) {
+        lru.clear();
+        exact.clear();
+        byStart.clear();
+        byGoal.clear();
+        invalidations_++;
+    }
+    version = grid.version();
+    synced = true;
+}
+
+// Copies cells [from, to] of e into out, with costs relative to cells[from]
+void PathCache::extract(const Entry& e, size_t from, size_t to, CachedPath& out) const {
+    out.found = e.found;
+    out.cost = e.found ? e.g[to] - e.g[from] : 0;
+    out.path.clear();
+    for (size_t i = from; e.found && i <= to; ++i) out.path.push_back(grid.point(e.cells[i]));
+}
+
+bool PathCache::lookup(Point start, Point goal, Solver solve, CachedPath& out) {
+    int s = grid.index(start.x, start.y);
+    int t = grid.index(goal.x, goal.y);
+    lock_guard<std::mutex> lock(guard);
+    syncVersion();
+
+    auto hit = exact.find(Key{ solve, s, t });
+    if (hit != exact.end()) {
+        lru.splice(lru.begin(), lru, hit->second);
+        extract(*hit->second, 0, hit->second->cells.empty() ? 0 : hit->second->cells.size() - 1, out);
+        hits_++;
+        return true;
+    }
+
+    // A cached path from the same start through the goal, or to the same goal through the start
+    for (int side = 0; side < 2; ++side) {
+        auto range = (side == 0 ? byStart : byGoal).equal_range(Key{ solve, side == 0 ? s : t, 0 });
+        int scanned = 0;
+        for (auto it = range.first; it != range.second && scanned < MAX_SUBPATH_CANDIDATES; ++it, ++scanned) {
+            const Entry& e = *it->second;
+            int wanted = side == 0 ? t : s;
+            for (size_t i = 0; i < e.cells.size(); ++i) {
+                if (e.cells[i] != wanted) continue;
+                if (side == 0) extract(e, 0, i, out);
+                else extract(e, i, e.cells.size() - 1, out);
+                lru.splice(lru.begin(), lru, it->second);
+                subpathHits_++;
+                return true;
+            }
+        }
+    }
+    misses_++;
+    return false;
+}
+
+// Turns the search just run on ctx into an entry
+PathCache::Entry PathCache::makeEntry(const SearchContext& ctx, Solver solve, bool found) const {
+    Entry e;
+    e.solve = solve;
+    e.start = grid.index(ctx.start.x, ctx.start.y);
+    e.goal = grid.index(ctx.goal.x, ctx.goal.y);
+    e.found = found;
+    if (found) {
+        e.cells.push_back(e.start);
+        if (e.goal != e.start) {
+            for (const Point& p : reconstructPath(ctx, ctx.goal)) e.cells.push_back(grid.index(p.x, p.y));
+            e.cells.push_back(e.goal);
+        }
+        // Solvers that keep no costs (DFS) are priced by step count
+        bool costed = ctx.nodes[e.goal].g != SearchContext::UNREACHED;
+        for (size_t i = 0; i < e.cells.size(); ++i)
+            e.g.push_back(costed ? (i == 0 ? 0 : ctx.nodes[e.cells[i]].g) : static_cast<int>(i));
+    }
+    return e;
+}
+
+// Inserts e unless the map changed after the search that produced it started
+void PathCache::store(Entry&& e, unsigned searchedVersion) {
+    lock_guard<std::mutex> lock(guard);
+    syncVersion();
+    if (version != searchedVersion) return;
+    Key key{ e.solve, e.start, e.goal };
+    auto existing = exact.find(key);
+    if (existing != exact.end()) { // Another thread stored it meanwhile
+        lru.splice(lru.begin(), lru, existing->second);
+        return;
+    }
+    bool found = e.found;
+    lru.push_front(std::move(e));
+    exact[key] = lru.begin();
+    if (found) {
+        byStart.insert({ Key{ key.solve, key.a, 0 }, lru.begin() });
+        byGoal.insert({ Key{ key.solve, key.b, 0 }, lru.begin() });
+    }
+    while (lru.size() > capacity) erase(prev(lru.end()));
+}
+
+void PathCache::insert(const SearchContext& ctx, Solver solve, bool found, unsigned searchedVersion) {
+    store(makeEntry(ctx, solve, found), searchedVersion);
+}
+
+void PathCache::eraseFrom(unordered_multimap<Key, Iter, KeyHash>& index, const Key& key, Iter it) {
+    auto range = index.equal_range(key);
+    for (auto i = range.first; i != range.second; ++i) {
+        if (i->second == it) {
+            index.erase(i);
+            return;
+        }
+    }
+}
+
+void PathCache::erase(Iter it) {
+    exact.erase(Key{ it->solve, it->start, it->goal });
+    if (it->found) {
+        eraseFrom(byStart, Key{ it->solve, it->start, 0 }, it);
+        eraseFrom(byGoal, Key{ it->solve, it->goal, 0 }, it);
+    }
+    lru.erase(it);
+}
+
+CachedPath PathCache::findPath(SearchContext& ctx, Solver solve) {
+    CachedPath result;
+    // Read before the lookup, so an edit at any point up to the end of the search shows
+    unsigned searchedVersion = grid.version();
+    if (lookup(ctx.start, ctx.goal, solve, result)) return result;
+
+    Entry e = makeEntry(ctx, solve, solve(ctx, nullptr));
+    extract(e, 0, e.cells.empty() ? 0 : e.cells.size() - 1, result);
+    store(std::move(e), searchedVersion);
+    return result;
+}
+
+void PathCache::clear() {
+    lock_guard<std::mutex> lock(guard);
+    lru.clear();
+    exact.clear();
+    byStart.clear();
+    byGoal.clear();
+}
+
+size_t PathCache::size() const {
+    lock_guard<std::mutex> lock(guard);
+    return lru.size();
+}
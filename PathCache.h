@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "Pathfinder.h"
+
+// Answer of a cached query
+struct CachedPath {
+    bool found = false;
+    int cost = 0;            // node(goal).g of the solve, or the cost along a reused sub-path
+    std::vector<Point> path; // start to goal, both included (the solver's waypoints for jps)
+};
+
+// Bounded LRU cache of solved queries on one grid, keyed by (map version, start, goal,
+// solver). Safe to share between threads: lookups and inserts take one mutex, and the
+// search on a miss runs outside it, in the caller's SearchContext.
+//
+// Besides exact repeats it answers a query from a cached path of the same solver that
+// passes through both ends: a goal on a cached path from the same start (a prefix) or a
+// start on a cached path to the same goal (a suffix). Sub-paths of shortest paths are
+// shortest paths, so those answers are what an optimal solver would find; for DFS or HPA*
+// they are valid paths but not necessarily the solver's own.
+//
+// The cache checks grid.version() on every query and drops everything when it changed,
+// so editing the map (and calling Grid::markEdited) invalidates all entries.
+class PathCache {
+public:
+    explicit PathCache(const Grid& grid, size_t capacity = 4096) : grid(grid), capacity(capacity ? capacity : 1) {}
+
+    // Answers ctx.start -> ctx.goal, running solve on ctx only on a miss
+    CachedPath findPath(SearchContext& ctx, Solver solve);
+
+    // The cached answer, if any; counts a hit or miss like findPath
+    bool lookup(Point start, Point goal, Solver solve, CachedPath& out);
+    // Stores the result of a search just run on ctx with solve. searchedVersion is
+    // grid.version() read before that search; if the map was edited since, the result may
+    // describe the old map and is dropped.
+    void insert(const SearchContext& ctx, Solver solve, bool found, unsigned searchedVersion);
+    void clear();
+
+    std::uint64_t hits() const { return hits_; }               // Exact repeats
+    std::uint64_t subpathHits() const { return subpathHits_; } // Answered from part of a cached path
+    std::uint64_t misses() const { return misses_; }
+    std::uint64_t invalidations() const { return invalidations_; } // Map edits that emptied the cache
+    size_t size() const;
+
+private:
+    struct Entry {
+        Solver solve;
+        int start, goal;        // Flat indices
+        bool found;
+        std::vector<int> cells; // start..goal, both included; empty if not found
+        std::vector<int> g;     // Cost from start at each cell
+    };
+    typedef std::list<Entry>::iterator Iter;
+
+    // (solver, cell) or (solver, start, goal), hashed for the indices below
+    struct Key {
+        Solver solve;
+        int a, b;
+        bool operator==(const Key& o) const { return solve == o.solve && a == o.a && b == o.b; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const;
+    };
+
+    Entry makeEntry(const SearchContext& ctx, Solver solve, bool found) const;
+    void store(Entry&& e, unsigned searchedVersion);
+    void syncVersion();
+    void extract(const Entry& e, size_t from, size_t to, CachedPath& out) const;
+    void erase(Iter it);
+    static void eraseFrom(std::unordered_multimap<Key, Iter, KeyHash>& index, const Key& key, Iter it);
+
+    const Grid& grid;
+    size_t capacity;
+    mutable std::mutex guard;
+    unsigned version = 0;
+    bool synced = false;
+    std::list<Entry> lru; // Most recently used first
+    std::unordered_map<Key, Iter, KeyHash> exact;
+    std::unordered_multimap<Key, Iter, KeyHash> byStart, byGoal; // Keyed by (solver, cell, 0); found paths only
+    std::atomic<std::uint64_t> hits_{ 0 }, subpathHits_{ 0 }, misses_{ 0 }, invalidations_{ 0 };
+};
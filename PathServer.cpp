@@ -0,0 +1,504 @@
+#include "PathServer.h"
+#include "MazeGenerator.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Bytes requested from a client per read
+static const size_t READ_CHUNK = 64 * 1024;
+// Longest text request line; a longer one is answered with an error and ends the connection
+static const size_t MAX_LINE = 4096;
+// Most pairs a "sample" request may ask for
+static const int MAX_SAMPLE = 1000000;
+
+// One client stream. The reader thread owns the input side. Workers hand completed
+// answers over under `guard`, and the connection's writer thread writes them out in
+// request order, so a client that stops reading only ever blocks its own writer (and,
+// through maxInFlight, its own reader).
+struct PathServer::Connection {
+    Connection(int in, int out, bool ownsFds) : in(in), out(out), ownsFds(ownsFds) {}
+
+    int in, out;
+    bool ownsFds;      // Socket connections close their descriptor when done
+    int mode = -1;     // -1 until the first bytes arrive, then 0 text or 1 binary
+    bool quit = false;
+    atomic<uint64_t> issued{ 0 }; // Requests read so far (changed by the reader thread only)
+    atomic<bool> finished{ false };
+
+    std::mutex guard;
+    condition_variable wake;     // Writer: an answer arrived, or reading ended
+    condition_variable drained;  // Reader: answers were written
+    map<uint64_t, string> ready; // Answers the writer hasn't taken yet
+    uint64_t taken = 0;          // First answer the writer hasn't taken
+    uint64_t written = 0;        // Answers written (or dropped, once broken)
+    bool reading = true;         // The reader may still issue requests
+    bool broken = false;         // A write failed; later answers are dropped
+};
+
+static long readSome(int fd, char* buffer, size_t size) {
+    for (;;) {
+#ifdef _WIN32
+        long n = _read(fd, buffer, static_cast<unsigned>(size));
+#else
+        long n = static_cast<long>(::read(fd, buffer, size));
+#endif
+        if (n >= 0 || errno != EINTR) return n;
+    }
+}
+
+// Writes all of data; a socket that the client closed fails the write instead of raising SIGPIPE
+static bool writeAll(int fd, bool socket, const char* data, size_t size) {
+    while (size > 0) {
+#ifdef _WIN32
+        (void)socket;
+        long n = _write(fd, data, static_cast<unsigned>(size));
+#elif defined(MSG_NOSIGNAL)
+        long n = static_cast<long>(socket ? ::send(fd, data, size, MSG_NOSIGNAL) : ::write(fd, data, size));
+#else
+        (void)socket;
+        long n = static_cast<long>(::write(fd, data, size));
+#endif
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static void closeFd(int fd) {
+#ifdef _WIN32
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+static void appendInt(string& out, long long value) {
+    char digits[24];
+    out.append(digits, to_chars(digits, digits + sizeof(digits), value).ptr);
+}
+
+static void appendBytes(string& out, const void* data, size_t size) {
+    out.append(static_cast<const char*>(data), size);
+}
+
+PathServer::PathServer(const Grid& grid, const ServerOptions& options, const JPSPlusTable* table)
+    : grid(grid), options(options), table(table), bits(grid) {
+    for (int i = 0; i < NUM_SOLVERS; ++i) names.push_back(SOLVERS[i].name);
+    names.push_back("jpsBits");
+    if (table) names.push_back("jpsPlus");
+    for (size_t i = 0; i < names.size(); ++i)
+        if (names[i] == options.solver) defaultSolver = static_cast<int>(i);
+
+    int threads = options.threads > 0 ? options.threads : defaultThreadCount();
+    this->options.maxBatch = max(1, options.maxBatch);
+    this->options.maxInFlight = max(1, options.maxInFlight);
+    this->options.threads = threads;
+    for (int w = 0; w < threads; ++w) workers.emplace_back([this, w] { work(w); });
+}
+
+PathServer::~PathServer() {
+    stop();
+    {
+        lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_all();
+    for (thread& t : workers) t.join();
+}
+
+// Runs solver number `solver` (an index into names) on ctx
+bool PathServer::solve(SearchContext& ctx, int solver) {
+    if (solver < NUM_SOLVERS) return SOLVERS[solver].solve(ctx, nullptr);
+    if (solver == NUM_SOLVERS) return jpsBits(ctx, bits);
+    return jpsPlus(ctx, *table);
+}
+
+// Worker thread: takes a fair share of the queue (at most maxBatch queries) at a time
+void PathServer::work(int) {
+    SearchContext ctx(grid);
+    vector<Job> batch;
+    string bytes;
+    for (;;) {
+        {
+            unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;
+            size_t share = (queue.size() + options.threads - 1) / options.threads;
+            size_t take = min(queue.size(), min(share, static_cast<size_t>(options.maxBatch)));
+            for (size_t i = 0; i < take; ++i) {
+                batch.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+        }
+        for (Job& job : batch) {
+            bytes.clear();
+            answer(ctx, job, bytes);
+            deliver(*job.conn, job.seq, std::move(bytes));
+            answered++;
+        }
+        batch.clear();
+    }
+}
+
+// Answers one query in the connection's protocol
+void PathServer::answer(SearchContext& ctx, const Job& job, string& out) {
+    if (!job.reply.empty()) {
+        out = job.reply;
+        return;
+    }
+
+    auto start_time = chrono::steady_clock::now();
+    int s = grid.index(job.start.x, job.start.y);
+    int t = grid.index(job.goal.x, job.goal.y);
+    ctx.start = job.start;
+    ctx.goal = job.goal;
+    ctx.stats = SearchStats();
+    bool found = grid.isValid(s) && grid.isValid(t) && solve(ctx, job.solver);
+
+    // Solvers that keep no costs (DFS) are priced by step count
+    bool costed = found && ctx.node(t).g != SearchContext::UNREACHED;
+    bool needPath = found && (job.wantPath || !costed);
+    if (needPath && s != t) reconstructPath(ctx, ctx.goal, ctx.path);
+    else ctx.path.clear();
+    int steps = found && s != t ? static_cast<int>(ctx.path.size()) + 1 : 0;
+    int cost = !found ? 0 : costed ? ctx.node(t).g : steps;
+    long long micros = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start_time).count();
+    uint32_t length = found && job.wantPath ? steps + 1 : 0;
+
+    if (job.conn->mode == 1) {
+        BinaryAnswer a;
+        a.seq = static_cast<uint32_t>(job.seq);
+        a.status = found ? 1 : 0;
+        a.cost = cost;
+        a.nodes = ctx.stats.nodesExplored;
+        a.pushes = ctx.stats.pushes;
+        a.pops = ctx.stats.pops;
+        a.micros = static_cast<uint32_t>(micros);
+        a.pathLength = length;
+        out.reserve(sizeof(a) + length * 2 * sizeof(int32_t));
+        appendBytes(out, &a, sizeof(a));
+        auto point = [&out](Point p) {
+            int32_t xy[2] = { p.x, p.y };
+            appendBytes(out, xy, sizeof(xy));
+        };
+        if (length > 0) {
+            point(job.start);
+            for (const Point& p : ctx.path) point(p);
+            if (s != t) point(job.goal);
+        }
+        return;
+    }
+
+    appendInt(out, static_cast<long long>(job.seq));
+    for (long long v : { static_cast<long long>(found), static_cast<long long>(cost),
+             static_cast<long long>(ctx.stats.nodesExplored), static_cast<long long>(ctx.stats.pushes),
+             static_cast<long long>(ctx.stats.pops), micros, static_cast<long long>(length) }) {
+        out += ' ';
+        appendInt(out, v);
+    }
+    auto point = [&out](Point p) {
+        out += ' ';
+        appendInt(out, p.x);
+        out += ' ';
+        appendInt(out, p.y);
+    };
+    if (length > 0) {
+        point(job.start);
+        for (const Point& p : ctx.path) point(p);
+        if (s != t) point(job.goal);
+    }
+    out += '\n';
+}
+
+// Hands an answer to the connection's writer; never blocks on the client
+void PathServer::deliver(Connection& conn, uint64_t seq, string&& bytes) {
+    {
+        lock_guard<std::mutex> lock(conn.guard);
+        conn.ready.emplace(seq, std::move(bytes));
+    }
+    conn.wake.notify_one();
+}
+
+// Writer thread of a connection: writes the answers that are next in request order,
+// outside the lock, until reading has ended and every issued request is answered
+void PathServer::writeLoop(Connection& conn) {
+    string out;
+    unique_lock<std::mutex> lock(conn.guard);
+    for (;;) {
+        conn.wake.wait(lock, [&conn] {
+            return (!conn.ready.empty() && conn.ready.begin()->first == conn.taken) ||
+                (!conn.reading && conn.taken == conn.issued);
+        });
+        if (conn.ready.empty() || conn.ready.begin()->first != conn.taken) return;
+
+        out.clear();
+        uint64_t count = 0;
+        for (auto it = conn.ready.begin(); it != conn.ready.end() && it->first == conn.taken; it = conn.ready.erase(it)) {
+            out += it->second;
+            conn.taken++;
+            count++;
+        }
+        bool broken = conn.broken;
+        lock.unlock();
+        if (!broken) broken = !writeAll(conn.out, conn.ownsFds, out.data(), out.size());
+        lock.lock();
+        conn.broken = broken;
+        conn.written += count;
+        conn.drained.notify_all();
+    }
+}
+
+// "seq sample ..." with count pairs of random open cells, or an error if none are found
+string PathServer::sample(int count, unsigned seed) const {
+    Rng rng(seed);
+    string out = " sample";
+    auto pick = [&](Point& p) {
+        for (int attempt = 0; attempt < 4096; ++attempt) {
+            p = Point(static_cast<int>(rng.below(grid.rows())), static_cast<int>(rng.below(grid.cols())));
+            if (grid.isValid(grid.index(p.x, p.y))) return true;
+        }
+        return false;
+    };
+    for (int i = 0; i < count; ++i) {
+        Point a, b;
+        if (!pick(a) || !pick(b)) return " error no open cells found";
+        for (int v : { a.x, a.y, b.x, b.y }) {
+            out += ' ';
+            appendInt(out, v);
+        }
+    }
+    return out;
+}
+
+// Parses the complete lines in data into at most `limit` jobs; returns the bytes consumed
+size_t PathServer::parseText(Connection& conn, const shared_ptr<Connection>& owner, const char* data, size_t size, size_t limit, vector<Job>& jobs) {
+    size_t consumed = 0;
+    while (!conn.quit && jobs.size() < limit) {
+        const char* end = static_cast<const char*>(memchr(data + consumed, '\n', size - consumed));
+        if (!end && size - consumed <= MAX_LINE) break;
+        if (!end || static_cast<size_t>(end - (data + consumed)) > MAX_LINE) {
+            jobs.push_back(Job{ owner, conn.issued++, Point(), Point(), -1, false, to_string(conn.issued - 1) + " error line too long\n" });
+            conn.quit = true;
+            return size;
+        }
+        string line(data + consumed, end);
+        consumed = end - data + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        size_t first = line.find_first_not_of(" \t");
+        if (first == string::npos || line[first] == '#') continue;
+
+        Job job{ owner, conn.issued++, Point(), Point(), defaultSolver, true, string() };
+        string seq = to_string(job.seq);
+        const char* p = line.c_str() + first;
+        long v[4];
+        int n = 0;
+        bool fitsInt = true; // Every number parsed fits an int, so casting it can't wrap
+        for (char* next; n < 4; ++n, p = next) {
+            errno = 0;
+            v[n] = strtol(p, &next, 10);
+            if (next == p) break;
+            fitsInt = fitsInt && errno != ERANGE && v[n] >= INT_MIN && v[n] <= INT_MAX;
+        }
+        string word;
+        for (; *p == ' ' || *p == '\t'; ++p) {}
+        for (; *p && *p != ' ' && *p != '\t'; ++p) word += *p;
+
+        if (n == 4) {
+            if (fitsInt) {
+                job.start = Point(static_cast<int>(v[0]), static_cast<int>(v[1]));
+                job.goal = Point(static_cast<int>(v[2]), static_cast<int>(v[3]));
+            }
+            if (!word.empty()) {
+                auto it = find(names.begin(), names.end(), word);
+                job.solver = it == names.end() ? -1 : static_cast<int>(it - names.begin());
+            }
+            if (job.solver < 0) job.reply = seq + " error unknown solver '" + word + "'\n";
+            else if (!fitsInt || !grid.inBounds(job.start.x, job.start.y) || !grid.inBounds(job.goal.x, job.goal.y))
+                job.reply = seq + " error point out of bounds\n";
+        }
+        else if (n == 0 && word == "info") {
+            job.reply = seq + " info " + to_string(grid.rows()) + " " + to_string(grid.cols()) + " ";
+            for (size_t i = 0; i < names.size(); ++i) job.reply += (i ? "," : "") + names[i];
+            job.reply += '\n';
+        }
+        else if (n == 0 && word == "sample") {
+            long count = 0, seed = 1;
+            char* next;
+            count = strtol(p, &next, 10);
+            if (next != p) seed = strtol(next, nullptr, 10);
+            if (count < 1 || count > MAX_SAMPLE) job.reply = seq + " error sample count must be 1.." + to_string(MAX_SAMPLE) + "\n";
+            else job.reply = seq + sample(static_cast<int>(count), static_cast<unsigned>(seed)) + "\n";
+        }
+        else if (n == 0 && word == "quit") {
+            conn.issued--; // Nothing to answer
+            conn.quit = true;
+            continue;
+        }
+        else {
+            job.reply = seq + " error expected \"sx sy gx gy [solver]\", info, sample or quit\n";
+        }
+        jobs.push_back(std::move(job));
+    }
+    return consumed;
+}
+
+// Parses the complete BinaryQuery records in data into at most `limit` jobs; returns the
+// bytes consumed
+size_t PathServer::parseBinary(Connection& conn, const shared_ptr<Connection>& owner, const char* data, size_t size, size_t limit, vector<Job>& jobs) {
+    size_t consumed = 0;
+    for (; size - consumed >= sizeof(BinaryQuery) && jobs.size() < limit; consumed += sizeof(BinaryQuery)) {
+        BinaryQuery q;
+        memcpy(&q, data + consumed, sizeof(q));
+        Job job{ owner, conn.issued++, Point(q.sx, q.sy), Point(q.gx, q.gy),
+            q.solver < 0 ? defaultSolver : q.solver, (q.flags & QUERY_WANT_PATH) != 0, string() };
+        if (q.solver >= static_cast<int>(names.size()) || !grid.inBounds(q.sx, q.sy) || !grid.inBounds(q.gx, q.gy)) {
+            BinaryAnswer a = { static_cast<uint32_t>(job.seq), -1, 0, 0, 0, 0, 0, 0 };
+            appendBytes(job.reply, &a, sizeof(a));
+        }
+        jobs.push_back(std::move(job));
+    }
+    return consumed;
+}
+
+// Reader thread of a connection: parses what arrives and queues it as one batch, but
+// reads no further while maxInFlight requests are queued or unwritten, so a client that
+// pipelines without reading its answers is held back by its socket buffers. Returns once
+// the client is done and every answer is written.
+void PathServer::readLoop(const shared_ptr<Connection>& owner) {
+    Connection& conn = *owner;
+    thread writer([this, &conn] { writeLoop(conn); });
+    string pending;
+    vector<char> chunk(READ_CHUNK);
+    vector<Job> jobs;
+    const uint64_t cap = static_cast<uint64_t>(options.maxInFlight);
+    while (!conn.quit) {
+        // Requests already buffered go first; read only when none is complete
+        if (conn.mode >= 0) {
+            uint64_t room;
+            {
+                unique_lock<std::mutex> lock(conn.guard);
+                conn.drained.wait(lock, [&] { return conn.broken || conn.issued - conn.written < cap; });
+                if (conn.broken) break; // The client is gone; stop reading
+                room = cap - (conn.issued - conn.written);
+            }
+            size_t used = conn.mode == 1 ? parseBinary(conn, owner, pending.data(), pending.size(), room, jobs)
+                                         : parseText(conn, owner, pending.data(), pending.size(), room, jobs);
+            pending.erase(0, used);
+            if (!jobs.empty()) {
+                {
+                    lock_guard<std::mutex> lock(queueMutex);
+                    for (Job& job : jobs) queue.push_back(std::move(job));
+                }
+                if (jobs.size() == 1) queueReady.notify_one();
+                else queueReady.notify_all();
+                jobs.clear();
+                continue;
+            }
+            if (conn.quit) break;
+        }
+
+        long n = readSome(conn.in, chunk.data(), chunk.size());
+        if (n <= 0) break;
+        pending.append(chunk.data(), static_cast<size_t>(n));
+
+        if (conn.mode < 0) {
+            size_t known = min(pending.size(), sizeof(BINARY_MAGIC));
+            bool magic = memcmp(pending.data(), BINARY_MAGIC, known) == 0;
+            if (magic && known < sizeof(BINARY_MAGIC)) continue; // Can't tell yet
+            conn.mode = magic ? 1 : 0;
+            if (magic) pending.erase(0, sizeof(BINARY_MAGIC));
+        }
+    }
+
+    {
+        lock_guard<std::mutex> lock(conn.guard);
+        conn.reading = false;
+    }
+    conn.wake.notify_one();
+    writer.join();
+    if (conn.ownsFds) closeFd(conn.in);
+    conn.finished = true;
+}
+
+void PathServer::serveStream(int in, int out) {
+    readLoop(make_shared<Connection>(in, out, false));
+}
+
+bool PathServer::serveSocket(const string& path) {
+#ifdef _WIN32
+    (void)path;
+    return false;
+#else
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) return false;
+    memcpy(addr.sun_path, path.c_str(), path.size());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 128) != 0) {
+        ::close(fd);
+        return false;
+    }
+    listenFd = fd;
+    listening = true;
+
+    vector<pair<thread, shared_ptr<Connection>>> readers;
+    while (listening) {
+        int client = accept(fd, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;
+        }
+        // Reap the readers of clients that are gone
+        for (size_t i = 0; i < readers.size();) {
+            if (readers[i].second->finished) {
+                readers[i].first.join();
+                readers[i] = std::move(readers.back());
+                readers.pop_back();
+            }
+            else {
+                ++i;
+            }
+        }
+        auto conn = make_shared<Connection>(client, client, true);
+        readers.emplace_back(thread([this, conn] { readLoop(conn); }), conn);
+    }
+
+    // Wake the readers still blocked on their clients, then wait for their answers
+    for (auto& r : readers)
+        if (!r.second->finished) shutdown(r.second->in, SHUT_RD);
+    for (auto& r : readers) r.first.join();
+    ::close(fd);
+    unlink(path.c_str());
+    listenFd = -1;
+    return true;
+#endif
+}
+
+void PathServer::stop() {
+#ifndef _WIN32
+    if (listening.exchange(false) && listenFd >= 0) shutdown(listenFd, SHUT_RDWR);
+#endif
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Pathfinder.h"
+#include "BitGrid.h"
+#include "JPSPlus.h"
+
+// Long-lived query service over one loaded map: clients send start/goal queries on a
+// byte stream (stdin/stdout, or a connection to a Unix domain socket) and get back the
+// path, its cost and the search counters. Readers parse whatever has arrived and queue
+// it as one batch; worker threads, each with its own SearchContext, take up to maxBatch
+// queries at a time, and a writer thread per connection sends the answers back. Clients
+// may pipeline queries: answers come back in request order on every connection. Once a
+// connection has maxInFlight requests queued or unwritten its reader waits for answers
+// to drain, so a client that stops reading stalls only itself.
+//
+// Text protocol, one request per line:
+//   sx sy gx gy [solver]   a query; solver is a name from solverNames() (default: the
+//                          server's); the answer is
+//                          "seq found cost nodes pushes pops micros length x y x y ..."
+//                          with the path from start to goal (jps variants: waypoints)
+//   info                   "seq info rows cols solver,solver,..."
+//   sample n [seed]        "seq sample sx sy gx gy ..." with n random pairs of open cells
+//   quit                   ends the connection after the answers still pending
+// Errors answer "seq error message". seq counts the connection's requests from 0.
+//
+// Binary protocol: a client that starts the stream with the four bytes BINARY_MAGIC sends
+// BinaryQuery records and reads BinaryAnswer records, each followed by pathLength (x, y)
+// int32 pairs. Fields are in host byte order, since both transports are local.
+
+const char BINARY_MAGIC[4] = { 'P', 'F', 'Q', 'B' };
+
+struct BinaryQuery {
+    std::int32_t sx, sy, gx, gy;
+    std::int32_t solver; // Index into solverNames(), or -1 for the server's default
+    std::int32_t flags;  // QUERY_WANT_PATH to get the path back
+};
+const std::int32_t QUERY_WANT_PATH = 1;
+
+struct BinaryAnswer {
+    std::uint32_t seq;
+    std::int32_t status; // 1 found, 0 no path, -1 bad query
+    std::int32_t cost;   // node(goal).g, in the solver's units (steps for DFS)
+    std::int32_t nodes, pushes, pops;
+    std::uint32_t micros;     // Search and path reconstruction time
+    std::uint32_t pathLength; // Cells that follow, start and goal included
+};
+
+struct ServerOptions {
+    int threads = 0;           // Worker threads; <= 0 means defaultThreadCount()
+    int maxBatch = 64;         // Queries a worker takes off the queue at once
+    int maxInFlight = 1024;    // Requests per connection read but not yet answered
+    std::string solver = "A*"; // For queries that name none
+};
+
+class PathServer {
+public:
+    // table may be a JPS+ table for grid (e.g. attached from a .pfm); jpsPlus is only
+    // offered with one. The grid must outlive the server and stay unchanged.
+    PathServer(const Grid& grid, const ServerOptions& options, const JPSPlusTable* table = nullptr);
+    ~PathServer();
+    PathServer(const PathServer&) = delete;
+    PathServer& operator=(const PathServer&) = delete;
+
+    // False if options.solver isn't one of solverNames()
+    bool valid() const { return defaultSolver >= 0; }
+    const std::vector<std::string>& solverNames() const { return names; }
+
+    // Serves one client reading from fd `in` and answering on `out` until end of input
+    // or "quit"; returns once every answer is written
+    void serveStream(int in, int out);
+    // Listens on a Unix domain socket at path (replacing a stale socket file) and serves
+    // each client that connects on its own reader thread, until stop(). False if the
+    // socket can't be set up (or the platform has no Unix domain sockets).
+    bool serveSocket(const std::string& path);
+    // Makes serveSocket return; safe to call from another thread
+    void stop();
+
+    // Requests answered so far, including info, sample and errors
+    std::uint64_t queriesAnswered() const { return answered; }
+
+private:
+    struct Connection;
+    struct Job {
+        std::shared_ptr<Connection> conn;
+        std::uint64_t seq;
+        Point start, goal;
+        int solver;
+        bool wantPath;
+        std::string reply; // Answer already known (info, sample, errors); no search
+    };
+
+    void work(int worker);
+    void readLoop(const std::shared_ptr<Connection>& conn);
+    void writeLoop(Connection& conn);
+    size_t parseText(Connection& conn, const std::shared_ptr<Connection>& owner, const char* data, size_t size, size_t limit, std::vector<Job>& jobs);
+    size_t parseBinary(Connection& conn, const std::shared_ptr<Connection>& owner, const char* data, size_t size, size_t limit, std::vector<Job>& jobs);
+    void answer(SearchContext& ctx, const Job& job, std::string& out);
+    void deliver(Connection& conn, std::uint64_t seq, std::string&& bytes);
+    std::string sample(int count, unsigned seed) const;
+    bool solve(SearchContext& ctx, int solver);
+
+    const Grid& grid;
+    ServerOptions options;
+    const JPSPlusTable* table;
+    BitGrid bits;
+    std::vector<std::string> names;
+    int defaultSolver = -1;
+
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::deque<Job> queue;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    std::atomic<bool> listening{ false };
+    int listenFd = -1;
+    std::atomic<std::uint64_t> answered{ 0 };
+};
@@ -0,0 +1,275 @@
+#include "Pathfinder.h"
+#include "BestFirst.h"
+#include "JumpPoint.h"
+#include "Bidirectional.h"
+
+#include <utility>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+// Directional arrays for 8-directional movement (used by JPS)
+const int dx_8[DIRS_8] = { -1, -1, 0, 1, 1, 1, 0, -1 }; // All 8 directions (N, NE, E, SE, S, SW, W, NW)
+const int dy_8[DIRS_8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+// Directional arrays for 4-directional (cardinal) movement
+const int dx_4[DIRS_4] = { -1, 1, 0, 0 }; // Up, Down, Left, Right
+const int dy_4[DIRS_4] = { 0, 0, -1, 1 };
+
+void Grid::resize(int rows, int cols) {
+    rows_ = rows;
+    cols_ = cols;
+    stride_ = cols + 2;
+    ++version_;
+    cells_.assign(static_cast<size_t>(rows + 2) * stride_, WALL);
+    for (int i = 0; i < DIRS_4; ++i) offset4[i] = dx_4[i] * stride_ + dy_4[i];
+    for (int i = 0; i < DIRS_8; ++i) offset8[i] = dx_8[i] * stride_ + dy_8[i];
+}
+
+#ifdef PATHFINDER_PROFILE
+thread_local SearchProfile* currentProfile = nullptr;
+#endif
+
+// Starts a new query generation
+void SearchContext::reset() {
+    stats = SearchStats();
+#ifdef PATHFINDER_PROFILE
+    profile = SearchProfile();
+    currentProfile = &profile;
+#endif
+    PROFILE_PHASE(profile, resetTicks);
+    if (nodes.size() != static_cast<size_t>(grid->size()) || ++epoch == 0) {
+        // First query on this grid, or the stamp wrapped: one full clear
+        nodes.assign(grid->size(), NodeState{ UNREACHED, -1, 0, false });
+        backNodes.clear();
+        epoch = 1;
+    }
+}
+
+void SearchContext::prepareBackward() {
+    if (backNodes.size() != nodes.size())
+        backNodes.assign(nodes.size(), NodeState{ UNREACHED, -1, 0, false });
+}
+
+// Initializes the grid with walls
+void initializeGrid(Grid& grid, int rows, int cols) {
+    grid.resize(rows, cols);
+}
+
+// Walks parent pointers back from p and returns the cells strictly between start and p
+vector<Point> reconstructPath(const SearchContext& ctx, Point p) {
+    vector<Point> path;
+    reconstructPath(ctx, p, path);
+    return path;
+}
+
+void reconstructPath(const SearchContext& ctx, Point p, vector<Point>& path) {
+    PROFILE_PHASE(ctx.profile, reconstructTicks);
+    const Grid& grid = *ctx.grid;
+    const vector<NodeState>& nodes = ctx.nodes;
+    path.clear();
+    int s = grid.index(ctx.start.x, ctx.start.y);
+    int last = grid.index(p.x, p.y);
+
+    // Backtrack from end to start and store in a vector
+    for (int idx = last; idx != s; idx = nodes[idx].parent) {
+        if (idx != last) path.push_back(grid.point(idx));
+    }
+
+    // Reverse path so it runs from start to end
+    reverse(path.begin(), path.end());
+}
+
+// Breadth-First Search (BFS) algorithm: the best-first engine with a FIFO queue
+bool bfs(SearchContext& ctx, SearchObserver* observer) {
+    return bestFirstSearch(ctx, ctx.queue, UniformCost(), ZeroHeuristic(), observer);
+}
+
+// Depth-First Search (DFS) algorithm. Iterative over ctx.stack; visits, parents and
+// observer calls happen in the same order as a recursive DFS trying dx_4/dy_4 in order.
+bool dfs(SearchContext& ctx, SearchObserver* observer) {
+    ctx.reset();
+    const Grid& grid = *ctx.grid;
+    vector<StackFrame>& stack = ctx.stack;
+    int s = grid.index(ctx.start.x, ctx.start.y);
+    int t = grid.index(ctx.goal.x, ctx.goal.y);
+    stack.clear();
+
+    if (!grid.isValid(s)) return false;
+    ctx.node(s).parent = s;
+    ctx.node(s).visited = true;
+    ctx.stats.nodesExplored++;
+    if (observer) observer->onExpand(ctx.start);
+    if (s == t) return true;
+    stack.push_back({ s, 0 });
+    ctx.stats.pushes++;
+
+    while (!stack.empty()) {
+        StackFrame& f = stack.back();
+        if (f.dir == DIRS_4) {
+            stack.pop_back();
+            ctx.stats.pops++;
+            continue;
+        }
+        int curr = f.cell;
+        int next = curr + grid.offset4[f.dir++];
+
+        if (grid.isValid(next) && !ctx.node(next).visited) {
+            NodeState& n = ctx.node(next);
+            n.parent = curr;
+
+            if (observer) observer->onVisit(grid.point(next));
+
+            n.visited = true;
+            ctx.stats.nodesExplored++;
+            if (observer) observer->onExpand(grid.point(next));
+            if (next == t) return true;
+            stack.push_back({ next, 0 });
+            ctx.stats.pushes++;
+        }
+    }
+    return false;
+}
+
+// Dijkstra's algorithm
+template <class OpenList, class Cost, int>
+bool dijkstra(SearchContext& ctx, OpenList& open, const Cost& cost, SearchObserver* observer) {
+    return bestFirstSearch(ctx, open, cost, ZeroHeuristic(), observer);
+}
+
+template <class OpenList>
+bool dijkstra(SearchContext& ctx, OpenList& open, SearchObserver* observer) {
+    return dijkstra(ctx, open, UniformCost(), observer);
+}
+
+// A* search algorithm
+template <class OpenList, class Cost, int>
+bool astar(SearchContext& ctx, OpenList& open, const Cost& cost, SearchObserver* observer) {
+    return bestFirstSearch(ctx, open, cost, ModelHeuristic<Cost>{ cost }, observer);
+}
+
+template <class OpenList>
+bool astar(SearchContext& ctx, OpenList& open, SearchObserver* observer) {
+    return astar(ctx, open, UniformCost(), observer);
+}
+
+// Scans from idx in a cardinal direction for JPS. step is the flat offset of one move
+// and side the offset perpendicular to it. Stops at the goal or at the first cell with
+// a forced neighbour (an open cell diagonally ahead whose side cell is blocked); returns
+// false on reaching a wall. Side cells slide forward with the scan, so every cell
+// beside the ray is read once.
+static bool jumpCardinal(const Grid& grid, int idx, int step, int side, int end, int& out) {
+    if (!grid.isValid(idx)) return false; // Wall or border
+    bool leftOpen = grid.isValid(idx - side);
+    bool rightOpen = grid.isValid(idx + side);
+
+    for (;;) {
+        if (idx == end) { // Reached endpoint
+            out = idx;
+            return true;
+        }
+        bool leftAhead = grid.isValid(idx + step - side);
+        bool rightAhead = grid.isValid(idx + step + side);
+        if ((leftAhead && !leftOpen) || (rightAhead && !rightOpen)) { // Found a forced neighbor
+            out = idx;
+            return true;
+        }
+
+        idx += step;
+        PROFILE_COUNT(jumpSteps);
+        if (!grid.isValid(idx)) return false;
+        leftOpen = leftAhead;
+        rightOpen = rightAhead;
+    }
+}
+
+// Jump function for JPS: follows (dx, dy) from idx until it finds a jump point.
+// A diagonal step also probes both of its cardinal components once per cell.
+static bool jump(const Grid& grid, int idx, int dx, int dy, int end, int& out) {
+    int stride = grid.stride();
+    if (dx == 0) return jumpCardinal(grid, idx, dy, stride, end, out);
+    if (dy == 0) return jumpCardinal(grid, idx, dx * stride, 1, end, out);
+
+    int vertical = dx * stride;
+    for (; grid.isValid(idx); idx += vertical + dy) {
+        PROFILE_COUNT(jumpSteps);
+        if (idx == end) { // Reached endpoint
+            out = idx;
+            return true;
+        }
+        // Obstacles behind the diagonal that force a turn
+        if ((grid.isValid(idx - vertical + dy) && !grid.isValid(idx - vertical)) ||
+            (grid.isValid(idx + vertical - dy) && !grid.isValid(idx - dy))) {
+            out = idx;
+            return true;
+        }
+        // Check if a jump point exists in cardinal directions
+        int temp;
+        if (jumpCardinal(grid, idx + vertical, vertical, 1, end, temp) ||
+            jumpCardinal(grid, idx + dy, dy, stride, end, temp)) {
+            out = idx;
+            return true;
+        }
+    }
+    return false; // Wall or border
+}
+
+// Grid-scanning jump used by jps
+struct GridJumper {
+    const Grid& grid;
+    bool operator()(int from, int dir, int end, int& out) const {
+        return jump(grid, from + grid.offset8[dir], dx_8[dir], dy_8[dir], end, out);
+    }
+};
+
+// Jump Point Search (JPS) algorithm
+template <class OpenList>
+bool jps(SearchContext& ctx, OpenList& open, SearchObserver* observer) {
+    return jumpPointSearch(ctx, open, GridJumper{ *ctx.grid }, observer);
+}
+
+// Default-policy entry points used by the solver table, on the context's own open list
+bool dijkstra(SearchContext& ctx, SearchObserver* observer) {
+    return dijkstra(ctx, ctx.open, observer);
+}
+
+bool astar(SearchContext& ctx, SearchObserver* observer) {
+    return astar(ctx, ctx.open, observer);
+}
+
+bool jps(SearchContext& ctx, SearchObserver* observer) {
+    return jps(ctx, ctx.open, observer);
+}
+
+// The best-first solvers are built for every open-list policy in OpenList.h, and
+// Dijkstra and A* for every cost model in CostModel.h
+#define INSTANTIATE_COST_MODEL(OpenList, Cost) \
+    template bool dijkstra<OpenList, Cost>(SearchContext&, OpenList&, const Cost&, SearchObserver*); \
+    template bool astar<OpenList, Cost>(SearchContext&, OpenList&, const Cost&, SearchObserver*);
+
+#define INSTANTIATE_BEST_FIRST(OpenList) \
+    template bool dijkstra<OpenList>(SearchContext&, OpenList&, SearchObserver*); \
+    template bool astar<OpenList>(SearchContext&, OpenList&, SearchObserver*); \
+    template bool jps<OpenList>(SearchContext&, OpenList&, SearchObserver*); \
+    INSTANTIATE_COST_MODEL(OpenList, UniformCost) \
+    INSTANTIATE_COST_MODEL(OpenList, TerrainCost) \
+    INSTANTIATE_COST_MODEL(OpenList, OctileCost)
+
+INSTANTIATE_BEST_FIRST(BinaryHeapOpenList)
+INSTANTIATE_BEST_FIRST(BucketQueue)
+INSTANTIATE_BEST_FIRST(RadixHeap)
+INSTANTIATE_BEST_FIRST(QuaternaryHeap)
+
+// Solver table, in menu order
+const SolverInfo SOLVERS[NUM_SOLVERS] = {
+    { "BFS", bfs },
+    { "DFS", dfs },
+    { "Dijkstra", dijkstra },
+    { "A*", astar },
+    { "JumpPoint", jps },
+    { "BiBFS", bidirectionalBfs },
+    { "BiDijkstra", bidirectionalDijkstra },
+    { "BiA*", bidirectionalAstar },
+};
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include "OpenList.h"
+#include "Profile.h"
+
+// Headless pathfinding core: maze state, generation and the search algorithms.
+// Nothing in here depends on SFML, so it can be linked into tools that have no display.
+
+// Default grid dimensions and tile types
+const int ROWS = 25;
+const int COLS = 50;
+const char WALL = '#';
+const char PATH = '.';
+const char START = 'S';
+const char END = 'E';
+const char VISITED = '*'; // For path visualization
+const char FINAL_PATH = 'P';  // Cyan path that is the final path
+const char EXPANDED = 'x'; // Visited and expanded, for replays that tell the two apart
+
+// Fixed-point move costs used by jps and the weighted cost models in CostModel.h: a
+// straight step costs COST_ONE and a diagonal one COST_DIAGONAL, sqrt(2) rounded down
+const int COST_ONE = 1024;
+const int COST_DIAGONAL = 1448;
+
+// Structure to represent a point (x, y) on the grid
+struct Point {
+    int x, y;
+    Point(int x = 0, int y = 0) : x(x), y(y) {}
+    // Overload operators for comparison
+    bool operator==(const Point& other) const { return x == other.x && y == other.y; }
+    bool operator<(const Point& other) const { return x != other.x ? x < other.x : y < other.y; }
+};
+
+// Directional arrays for 8-directional movement (used by JPS)
+const int DIRS_8 = 8;
+extern const int dx_8[DIRS_8];
+extern const int dy_8[DIRS_8];
+
+// Directional arrays for 4-directional (cardinal) movement (used by maze generation, BFS, DFS, Dijkstra, A*)
+const int DIRS_4 = 4;
+extern const int dx_4[DIRS_4];
+extern const int dy_4[DIRS_4];
+
+// Maze of runtime size stored as one row-major buffer. The buffer is padded with a
+// one-cell WALL border, so any in-bounds cell's neighbours can be read without bounds checks.
+// Cells are addressed either by (x, y) or by their flat index into the padded buffer.
+class Grid {
+public:
+    Grid(int rows = 0, int cols = 0) { resize(rows, cols); }
+
+    // Reallocates the grid; every cell (and the border) becomes WALL
+    void resize(int rows, int cols);
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    int stride() const { return stride_; }
+    // Number of cells in the padded buffer; flat indices range over [0, size())
+    int size() const { return static_cast<int>(cells_.size()); }
+
+    int index(int x, int y) const { return (x + 1) * stride_ + (y + 1); }
+    Point point(int idx) const { return Point(idx / stride_ - 1, idx % stride_ - 1); }
+    bool inBounds(int x, int y) const { return x >= 0 && y >= 0 && x < rows_ && y < cols_; }
+
+    char& at(int x, int y) { return cells_[index(x, y)]; }
+    char at(int x, int y) const { return cells_[index(x, y)]; }
+    char& operator[](int idx) { return cells_[idx]; }
+    char operator[](int idx) const { return cells_[idx]; }
+
+    // Not a wall. Valid for any index in the padded buffer, including the border.
+    bool isValid(int idx) const {
+        PROFILE_COUNT(isValidCalls);
+        return cells_[idx] != WALL;
+    }
+
+    // Map version: bumped by resize() and by markEdited(), which code that opens or closes
+    // cells of a grid in use calls afterwards. Caches (PathCache) compare it to notice edits.
+    unsigned version() const { return version_; }
+    void markEdited() { ++version_; }
+
+    // Flat index offsets matching dx_4/dy_4 and dx_8/dy_8
+    int offset4[DIRS_4];
+    int offset8[DIRS_8];
+
+private:
+    int rows_ = 0, cols_ = 0, stride_ = 2;
+    unsigned version_ = 0;
+    std::vector<char> cells_;
+};
+
+// Per-node search state, packed so a relaxation touches a single record
+struct NodeState {
+    int g;          // Cost from start (dist for Dijkstra, gScore for A* and JPS)
+    int parent;     // Flat index of the predecessor, -1 if none
+    unsigned epoch; // Query generation that last wrote this record
+    bool visited;   // Closed / discovered flag
+};
+
+// Frame of the explicit DFS stack: a cell and the next direction to try from it
+struct StackFrame {
+    int cell;
+    int dir;
+};
+
+// Optional hook the solvers report progress through. A null observer means a
+// full-speed headless run; the visualizer attaches one to animate the search.
+struct SearchObserver {
+    virtual ~SearchObserver() {}
+    // Called whenever a node is relaxed (pushed onto the frontier)
+    virtual void onVisit(Point p) = 0;
+    // Called when a node is expanded (taken off the frontier and its neighbours scanned)
+    virtual void onExpand(Point) {}
+};
+
+// Counters filled in by every solver
+struct SearchStats {
+    int nodesExplored = 0;
+    int pushes = 0; // Open-list insertions (and decrease-keys); queue/stack pushes for BFS/DFS
+    int pops = 0;   // Open-list removals, including stale entries skipped by lazy deletion
+    // Bidirectional solvers only: nodesExplored split into the searches from start and from goal
+    int expandedForward = 0;
+    int expandedBackward = 0;
+};
+
+// State of one start/goal query. The grid is only read, so any number of
+// contexts (e.g. one per worker thread) can search the same Grid concurrently.
+//
+// Node records are generation-stamped: reset() only bumps the epoch, and a record
+// whose stamp is stale reads as untouched the first time node() returns it. A query
+// therefore costs time proportional to the nodes it touches, not to the grid size.
+class SearchContext {
+public:
+    explicit SearchContext(const Grid& grid) : grid(&grid) {}
+
+    const Grid* grid;
+    Point start;
+    Point goal;
+    std::vector<NodeState> nodes;
+    unsigned epoch = 0;
+    std::vector<StackFrame> stack; // Explicit DFS stack, reused across queries
+    std::vector<NodeState> backNodes; // Records of the backward half of bidirectional searches
+
+    // Workspace of the solvers called without an open list, reused across queries: once a
+    // context has seen its largest query, further queries make no heap allocations
+    BinaryHeapOpenList open;      // Dijkstra, A*, the JPS variants, HPA* and the forward bidirectional side
+    BinaryHeapOpenList backOpen;  // Backward side of bidirectional Dijkstra and A*
+    FifoQueue queue;              // BFS
+    std::vector<int> frontier[3]; // Bidirectional BFS: each side's frontier and the next level
+    std::vector<Point> path;      // Buffer for reconstructPath(ctx, p, ctx.path)
+    SearchStats stats;
+    // Hot-path counters and phase times (see Profile.h); all zero unless built with
+    // PATHFINDER_PROFILE. Mutable so reconstructPath can time itself on a const context.
+    mutable SearchProfile profile;
+
+    // Starts a new query: O(1) except when the grid was resized or the epoch wraps around
+    void reset();
+    // Sizes backNodes for the grid; bidirectional solvers call it after reset()
+    void prepareBackward();
+
+    // The record for a flat index, lazily cleared if an earlier query wrote it
+    NodeState& node(int idx) {
+        NodeState& n = nodes[idx];
+        if (n.epoch != epoch) n = NodeState{ UNREACHED, -1, epoch, false };
+        return n;
+    }
+    // True if the current query has written this record
+    bool touched(int idx) const { return nodes[idx].epoch == epoch; }
+    // Same as node(), for the backward search
+    NodeState& backNode(int idx) {
+        NodeState& n = backNodes[idx];
+        if (n.epoch != epoch) n = NodeState{ UNREACHED, -1, epoch, false };
+        return n;
+    }
+
+    static const int UNREACHED = 0x7fffffff;
+};
+
+// Resets the grid to rows x cols walls; the generators in MazeGenerator.h carve from there
+void initializeGrid(Grid& grid, int rows = ROWS, int cols = COLS);
+
+// Search algorithms; each returns true if ctx.goal was reached from ctx.start. jps (like
+// jpsBits and jpsPlus) moves 8-connected with corner cutting and prices its moves as
+// octile distance, so its g values are in COST_ONE units; the others count steps.
+bool bfs(SearchContext& ctx, SearchObserver* observer = nullptr);
+bool dfs(SearchContext& ctx, SearchObserver* observer = nullptr);
+bool dijkstra(SearchContext& ctx, SearchObserver* observer = nullptr);
+bool astar(SearchContext& ctx, SearchObserver* observer = nullptr);
+bool jps(SearchContext& ctx, SearchObserver* observer = nullptr);
+
+// Best-first solvers with a caller-supplied open list (see OpenList.h). Passing the
+// same open list to consecutive queries reuses its storage. The overloads above use
+// ctx.open, a BinaryHeapOpenList. Instantiated for every policy declared in OpenList.h.
+template <class OpenList>
+bool dijkstra(SearchContext& ctx, OpenList& open, SearchObserver* observer = nullptr);
+template <class OpenList>
+bool astar(SearchContext& ctx, OpenList& open, SearchObserver* observer = nullptr);
+template <class OpenList>
+bool jps(SearchContext& ctx, OpenList& open, SearchObserver* observer = nullptr);
+
+// Dijkstra and A* under a cost model from CostModel.h (terrain weights, octile moves).
+// node(goal).g is then in the model's units. Instantiated for every open-list policy
+// with UniformCost, TerrainCost and OctileCost; the overloads without a model use
+// UniformCost and compile to the same cost-1 code as before. The unnamed parameter keeps
+// calls like astar(ctx, open, nullptr) off these overloads.
+template <class OpenList, class Cost, int = Cost::DIRS>
+bool dijkstra(SearchContext& ctx, OpenList& open, const Cost& cost, SearchObserver* observer = nullptr);
+template <class OpenList, class Cost, int = Cost::DIRS>
+bool astar(SearchContext& ctx, OpenList& open, const Cost& cost, SearchObserver* observer = nullptr);
+
+// Solver table, in menu order
+typedef bool (*Solver)(SearchContext& ctx, SearchObserver* observer);
+struct SolverInfo {
+    const char* name;
+    Solver solve;
+};
+const int NUM_SOLVERS = 8;
+extern const SolverInfo SOLVERS[NUM_SOLVERS];
+
+// Heuristics, inline so the solvers' relaxation loops don't pay for a call
+inline int heuristic_manhattan(Point a, Point b) {
+    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+}
+// Chebyshev distance: 8-directional movement with unit-cost diagonals
+inline int heuristic_chebyshev(Point a, Point b) {
+    return std::max(std::abs(a.x - b.x), std::abs(a.y - b.y));
+}
+// Octile distance in fixed-point units: COST_DIAGONAL per diagonal step, COST_ONE per straight one
+inline int heuristic_octile(Point a, Point b) {
+    int dx = std::abs(a.x - b.x), dy = std::abs(a.y - b.y);
+    int diagonal = std::min(dx, dy);
+    return COST_DIAGONAL * diagonal + COST_ONE * (std::max(dx, dy) - diagonal);
+}
+
+// Walks parent pointers back from p and returns the cells strictly between ctx.start and p, in start-to-p order
+std::vector<Point> reconstructPath(const SearchContext& ctx, Point p);
+// Same, into a caller-owned buffer (such as ctx.path) whose capacity is reused
+void reconstructPath(const SearchContext& ctx, Point p, std::vector<Point>& path);
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define PATHFINDER_HAS_RDTSC 1
+#endif
+
+// Hot-path instrumentation for the solvers. Built with -DPATHFINDER_PROFILE, every query
+// fills ctx.profile with the counters and phase timers below; without it the PROFILE_*
+// macros expand to nothing, the profile stays zero and the solvers compile to the same
+// code as before. Every translation unit of a build must agree on the flag, since
+// Grid::isValid (an inline function) counts its calls when it is set.
+//
+// Counting happens where no SearchContext is at hand (Grid::isValid, the jump functions),
+// so the counters go through a per-thread pointer that SearchContext::reset() aims at
+// the profile of the query it starts. Work done on a thread between queries, such as
+// building a JPS+ table, is charged to the last query reset on that thread. Destroying a
+// context clears the pointer of its own thread only, so destroy contexts on the thread
+// that searched with them (as every solver and tool here does).
+
+struct SearchProfile;
+#ifdef PATHFINDER_PROFILE
+// Profile of the query running on this thread (defined in Pathfinder.cpp); null before
+// the first query and after that query's context is destroyed on this thread
+extern thread_local SearchProfile* currentProfile;
+#endif
+
+// Counters and phase times of one query. Times are in profileTicks() units.
+struct SearchProfile {
+#ifdef PATHFINDER_PROFILE
+    SearchProfile() = default;
+    SearchProfile(const SearchProfile&) = default;
+    SearchProfile& operator=(const SearchProfile&) = default;
+    ~SearchProfile() {
+        if (currentProfile == this) currentProfile = nullptr;
+    }
+#endif
+
+    std::uint64_t stalePops = 0;    // Pops of a node already closed (lazy deletion)
+    std::uint64_t isValidCalls = 0; // Grid::isValid, the wall test of every solver
+    std::uint64_t jumpCalls = 0;    // Jumps started by the JPS variants
+    std::uint64_t jumpSteps = 0;    // Cells those jumps stepped over (64-cell words for jpsBits,
+                                    // table entries read for jpsPlus)
+    std::uint64_t firstMoveLookups = 0; // FirstMoveTable::firstMove calls, one per step of firstMovePath
+    std::uint64_t resetTicks = 0;   // SearchContext::reset
+    std::uint64_t reconstructTicks = 0; // reconstructPath
+};
+
+#ifdef PATHFINDER_PROFILE
+constexpr bool PROFILE_ENABLED = true;
+#else
+constexpr bool PROFILE_ENABLED = false;
+#endif
+
+// Fine-grained clock of the phase timers: the time-stamp counter where there is one,
+// else steady_clock nanoseconds
+inline std::uint64_t profileTicks() {
+#ifdef PATHFINDER_HAS_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// profileTicks() per microsecond, measured against steady_clock on the first call (~10 ms)
+inline double profileTicksPerMicrosecond() {
+#ifdef PATHFINDER_HAS_RDTSC
+    static const double rate = [] {
+        auto t0 = std::chrono::steady_clock::now();
+        std::uint64_t c0 = profileTicks();
+        while (std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(10)) {}
+        std::uint64_t c1 = profileTicks();
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        return static_cast<double>(c1 - c0) / us;
+    }();
+    return rate;
+#else
+    return 1000.0;
+#endif
+}
+
+inline double profileMicroseconds(std::uint64_t ticks) { return ticks / profileTicksPerMicrosecond(); }
+
+// Adds the ticks between its construction and destruction to `total`
+class PhaseTimer {
+public:
+    explicit PhaseTimer(std::uint64_t& total) : total(total), start(profileTicks()) {}
+    ~PhaseTimer() { total += profileTicks() - start; }
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    std::uint64_t& total;
+    std::uint64_t start;
+};
+
+#ifdef PATHFINDER_PROFILE
+#define PROFILE_ADD(field, n) \
+    do { if (SearchProfile* profile_ = currentProfile) profile_->field += (n); } while (0)
+#define PROFILE_PHASE(profile, field) PhaseTimer profilePhase_##field((profile).field)
+#else
+#define PROFILE_ADD(field, n) do {} while (0)
+#define PROFILE_PHASE(profile, field) do {} while (0)
+#endif
+#define PROFILE_COUNT(field) PROFILE_ADD(field, 1)
@@ -0,0 +1,10 @@
+#include "SearchLog.h"
+
+using namespace std;
+
+bool recordSearch(SearchContext& ctx, Solver solve, SearchLog& log) {
+    log.clear();
+    bool found = solve(ctx, &log);
+    if (found) log.addPath(reconstructPath(ctx, ctx.goal));
+    return found;
+}
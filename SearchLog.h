@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Pathfinder.h"
+
+// What happened to a cell during a recorded search
+enum class SearchEvent : std::uint8_t {
+    Expand, // Taken off the frontier
+    Relax,  // Reached with a better cost and pushed onto the frontier
+    Path    // Part of the final path (recorded after the search, in start-to-goal order)
+};
+
+// Compact record of one search, filled in as a SearchObserver while the solver runs at
+// full speed, for the visualizer to replay at its own pace. Each event is one 32-bit
+// word: the flat grid index shifted left by two, plus the event type.
+class SearchLog : public SearchObserver {
+public:
+    explicit SearchLog(const Grid& grid) : grid(&grid) {}
+
+    void clear() {
+        events.clear();
+        pathEvents = 0;
+    }
+
+    void onVisit(Point p) override { add(SearchEvent::Relax, p); }
+    void onExpand(Point p) override { add(SearchEvent::Expand, p); }
+    void addPath(const std::vector<Point>& path) {
+        for (Point p : path) add(SearchEvent::Path, p);
+        pathEvents += static_cast<int>(path.size());
+    }
+
+    size_t size() const { return events.size(); }
+    SearchEvent type(size_t i) const { return static_cast<SearchEvent>(events[i] & 3); }
+    Point point(size_t i) const { return grid->point(static_cast<int>(events[i] >> 2)); }
+    // Cells on the recorded path, excluding start and goal
+    int pathLength() const { return pathEvents; }
+
+private:
+    void add(SearchEvent type, Point p) {
+        events.push_back(static_cast<std::uint32_t>(grid->index(p.x, p.y)) << 2 | static_cast<std::uint32_t>(type));
+    }
+
+    const Grid* grid;
+    std::vector<std::uint32_t> events;
+    int pathEvents = 0;
+};
+
+// Clears the log, runs solve on ctx with the log attached and, if the goal was reached,
+// appends the path. Returns what the solver returned.
+bool recordSearch(SearchContext& ctx, Solver solve, SearchLog& log);
@@ -0,0 +1,135 @@
+// Headless path query service; see PathServer.h for the protocols. Links against the core
+// library only, no SFML.
+//
+// Usage:
+//   PathServer [--map file.pfm|file.map] [--generate spec rows cols seed] [--socket path]
+//              [--threads n] [--batch n] [--inflight n] [--solver name] [--jpsplus]
+//
+// Loads the map once (a .pfm file, a MovingAI .map file, or a generated map whose spec is
+// "maze", "prim:10", "random:20", ...; default "random:20 1024 1024 1"), then answers
+// queries on stdin/stdout, or on every connection to the Unix domain socket at `path`.
+// --inflight caps the requests a connection may have unanswered (default 1024).
+// --jpsplus offers jpsPlus, building the table unless the .pfm file carries one.
+// SIGINT/SIGTERM stop a socket server cleanly. Progress and errors go to stderr.
+
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "Pathfinder.h"
+#include "MazeGenerator.h"
+#include "MapFile.h"
+#include "PathServer.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+using namespace std;
+
+// Returns the value after --name, or fallback if the flag wasn't given
+static string flagArg(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 0; i + 1 < argc; ++i)
+        if (argv[i] == "--" + name) return argv[i + 1];
+    return fallback;
+}
+
+static bool hasFlag(int argc, char* argv[], const string& name) {
+    for (int i = 0; i < argc; ++i)
+        if (argv[i] == "--" + name) return true;
+    return false;
+}
+
+// The socket server SIGINT/SIGTERM stop (PathServer::stop only shuts a socket down)
+static PathServer* running = nullptr;
+
+static void stopRunning(int) {
+    if (running) running->stop();
+}
+
+static bool endsWith(const string& s, const string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int main(int argc, char* argv[]) {
+    auto start_time = chrono::steady_clock::now();
+    Grid grid;
+    MapFile file;
+    JPSPlusTable table;
+    bool haveTable = false;
+
+    string path = flagArg(argc, argv, "map", "");
+    if (endsWith(path, ".pfm")) {
+        if (!file.open(path)) {
+            cerr << "Cannot open map file " << path << endl;
+            return 1;
+        }
+        loadGrid(file, grid);
+        haveTable = hasFlag(argc, argv, "jpsplus") && attachJpsPlus(file, grid, table);
+    }
+    else if (!path.empty()) {
+        if (!importMovingAiMap(path, grid)) {
+            cerr << "Cannot read MovingAI map " << path << endl;
+            return 1;
+        }
+    }
+    else {
+        string spec = "random:20";
+        int rows = 1024, cols = 1024;
+        unsigned seed = 1;
+        for (int i = 0; i + 4 < argc; ++i) {
+            if (strcmp(argv[i], "--generate") != 0) continue;
+            spec = argv[i + 1];
+            rows = atoi(argv[i + 2]);
+            cols = atoi(argv[i + 3]);
+            seed = static_cast<unsigned>(atoi(argv[i + 4]));
+        }
+        if (rows < 1 || cols < 1 || !buildMap(grid, spec, rows, cols, seed)) {
+            cerr << "Unknown map '" << spec << "' or bad size" << endl;
+            return 1;
+        }
+    }
+    if (hasFlag(argc, argv, "jpsplus") && !haveTable) {
+        table.build(grid);
+        haveTable = true;
+    }
+
+    ServerOptions options;
+    options.threads = atoi(flagArg(argc, argv, "threads", "0").c_str());
+    options.maxBatch = atoi(flagArg(argc, argv, "batch", "64").c_str());
+    options.maxInFlight = atoi(flagArg(argc, argv, "inflight", "1024").c_str());
+    options.solver = flagArg(argc, argv, "solver", options.solver);
+    PathServer server(grid, options, haveTable ? &table : nullptr);
+    if (!server.valid()) {
+        cerr << "Unknown solver '" << options.solver << "'; choose from:";
+        for (const string& name : server.solverNames()) cerr << " " << name;
+        cerr << endl;
+        return 1;
+    }
+    double loadMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+    cerr << "Map " << grid.rows() << "x" << grid.cols() << " ready in " << loadMs << " ms" << endl;
+
+    string socketPath = flagArg(argc, argv, "socket", "");
+    if (socketPath.empty()) {
+#ifdef _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        server.serveStream(0, 1);
+    }
+    else {
+        cerr << "Listening on " << socketPath << endl;
+        running = &server;
+        signal(SIGINT, stopRunning);
+        signal(SIGTERM, stopRunning);
+        if (!server.serveSocket(socketPath)) {
+            cerr << "Cannot listen on " << socketPath << endl;
+            return 1;
+        }
+    }
+    cerr << server.queriesAnswered() << " requests answered" << endl;
+    return 0;
+}
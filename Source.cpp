@@ -1,533 +1,310 @@
 #include <iostream>
-#include <queue>
-#include <stack>
 #include <chrono>
 #include <cstdlib>
 #include <ctime>
-#include <cstring>
-#include <limits>
 #include <string>
-#include <algorithm>
 #include <vector>
 #include <SFML/Graphics.hpp>
 #include <iomanip>
+#include <algorithm>
+#include <random>
+#include "Pathfinder.h"
+#include "MazeGenerator.h"
+#include "SearchLog.h"
 
 using namespace std;
 
-// Constants for grid dimensions and tile types
-const int ROWS = 25;
-const int COLS = 50;
-const char WALL = '#';
-const char PATH = '.';
-const char START = 'S';
-const char END = 'E';
-const char VISITED = '*'; // For path visualization
-const char FINAL_PATH = 'P';  // Cyan path that is the final path
-
-// Constants for SFML window and tile size
+// Largest cell pitch in pixels; bigger grids shrink it so the window fits the screen
 const int TILE_SIZE = 20;
-const int WINDOW_WIDTH = COLS * TILE_SIZE;
-const int WINDOW_HEIGHT = ROWS * TILE_SIZE;
-
-// Structure to represent a point (x, y) on the grid
-struct Point {
-    int x, y;
-    Point(int x = 0, int y = 0) : x(x), y(y) {}
-    // Overload operators for comparison
-    bool operator==(const Point& other) const { return x == other.x && y == other.y; }
-    bool operator<(const Point& other) const { return x != other.x ? x < other.x : y < other.y; }
-};
-void delay(int milliseconds) {
-    sf::sleep(sf::milliseconds(milliseconds));
-}
-// Global grid, visited status, parent pointers, and distance arrays
-char grid[ROWS][COLS];
-bool visited[ROWS][COLS];
-Point parent[ROWS][COLS]; // To reconstruct the path
-int dist[ROWS][COLS];     // For Dijkstra's algorithm
-int gScore[ROWS][COLS];   // For A* and JPS (cost from start to current)
-
-// Start and end points of the maze
-Point start(0, 0);
-Point endpoint(ROWS - 1, COLS - 1);
-
-// Directional arrays for 8-directional movement (used by JPS)
-const int DIRS_8 = 8;
-int dx_8[DIRS_8] = { -1, -1, 0, 1, 1, 1, 0, -1 }; // All 8 directions (N, NE, E, SE, S, SW, W, NW)
-int dy_8[DIRS_8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+const int MAX_WINDOW_WIDTH = 1600;
+const int MAX_WINDOW_HEIGHT = 900;
 
-// Directional arrays for 4-directional (cardinal) movement (used by maze generation, BFS, DFS, Dijkstra, A*)
-const int DIRS_4 = 4;
-int dx_4[DIRS_4] = { -1, 1, 0, 0 }; // Up, Down, Left, Right
-int dy_4[DIRS_4] = { 0, 0, -1, 1 };
-
-// Checks if a given coordinate is within grid bounds and not a wall
-bool isValid(int x, int y) {
-    return x >= 0 && y >= 0 && x < ROWS && y < COLS && grid[x][y] != WALL;
+// Cell pitch for a rows x cols grid: TILE_SIZE, or less (down to 1 px) for large grids
+int tileSizeFor(int rows, int cols) {
+    return max(1, min(TILE_SIZE, min(MAX_WINDOW_WIDTH / cols, MAX_WINDOW_HEIGHT / rows)));
 }
 
-// Initializes the grid with walls and resets visited status
-void initializeGrid() {
-    for (int i = 0; i < ROWS; ++i)
-        for (int j = 0; j < COLS; ++j)
-            grid[i][j] = WALL;
-    memset(visited, false, sizeof(visited)); // Reset visited array
+// Window size for a grid drawn at `tile` px per cell. Grids that don't fit even at 1 px
+// get a window scaled down to the maximum size, keeping their aspect ratio; a view over
+// the whole grid then shrinks the drawing to match.
+sf::Vector2u windowSizeFor(int rows, int cols, int tile) {
+    double width = static_cast<double>(cols) * tile, height = static_cast<double>(rows) * tile;
+    double scale = min(1.0, min(MAX_WINDOW_WIDTH / width, MAX_WINDOW_HEIGHT / height));
+    return sf::Vector2u(max(1u, static_cast<unsigned>(width * scale)), max(1u, static_cast<unsigned>(height * scale)));
 }
 
-// Carves paths in the maze using Depth-First Search (DFS)
-void carvePathDFS(Point curr) {
-    visited[curr.x][curr.y] = true;
-    grid[curr.x][curr.y] = PATH;
-
-    // Randomize directions for a more organic maze
-    int dirs[] = { 0, 1, 2, 3 }; // Using indices for dx_4, dy_4
-    random_shuffle(dirs, dirs + 4);
-
-    for (int i = 0; i < 4; ++i) {
-        int dir_idx = dirs[i];
-        // Calculate new position by moving two steps in a direction
-        int nx = curr.x + dx_4[dir_idx] * 2;
-        int ny = curr.y + dy_4[dir_idx] * 2;
-
-        // Check if the new position is valid and not visited
-        if (nx >= 0 && nx < ROWS && ny >= 0 && ny < COLS && !visited[nx][ny]) {
-            // Carve the path between current and new position
-            grid[curr.x + dx_4[dir_idx]][curr.y + dy_4[dir_idx]] = PATH;
-            carvePathDFS(Point(nx, ny)); // Recurse
-        }
+// Display colour of a cell
+sf::Color cellColor(char cell) {
+    switch (cell) {
+    case WALL:       return sf::Color::White;
+    case PATH:       return sf::Color::Black;
+    case START:      return sf::Color(255, 0, 255);
+    case END:        return sf::Color(158, 135, 204);
+    case VISITED:    return sf::Color(242, 216, 253);
+    case EXPANDED:   return sf::Color(214, 170, 240);
+    case FINAL_PATH: return sf::Color(151, 29, 136);
+    default:         return sf::Color::Magenta;
     }
 }
 
-// Generates a maze ensuring it's solvable and adds some randomness
-void guaranteeSolvableMaze() {
-    initializeGrid();
-    carvePathDFS(start); // Start carving from the start point
-
-    // Ensure start and end points are paths
-    grid[start.x][start.y] = START;
-    grid[endpoint.x][endpoint.y] = END;
-
-    // Ensure the endpoint is reachable if it was accidentally a wall
-    if (grid[endpoint.x][endpoint.y] == WALL) grid[endpoint.x][endpoint.y] = PATH;
-    // Also ensure neighbors of endpoint are path if they were walls, to aid reachability
-    if (endpoint.x > 0 && grid[endpoint.x - 1][endpoint.y] == WALL) grid[endpoint.x - 1][endpoint.y] = PATH;
-    if (endpoint.y > 0 && grid[endpoint.x][endpoint.y - 1] == WALL) grid[endpoint.x][endpoint.y - 1] = PATH;
-
-    // Add some random paths to make the maze less sparse and more interesting
-    for (int i = 1; i < ROWS - 1; ++i) {
-        for (int j = 1; j < COLS - 1; ++j) {
-            if (grid[i][j] == WALL && rand() % 100 < 40) { // 40% chance to turn a wall into a path
-                grid[i][j] = PATH;
+// Draws a grid as one quad per cell in a persistent vertex array. Only cells marked dirty
+// since the last draw are recoloured, and the whole grid goes out in a single draw call.
+class GridRenderer {
+public:
+    // Lays out the quads for every cell; tile is the cell pitch, with a 1 px border from 4 px up
+    void build(const Grid& grid, int tile) {
+        rows = grid.rows();
+        cols = grid.cols();
+        float size = static_cast<float>(tile >= 4 ? tile - 1 : tile);
+        vertices.setPrimitiveType(sf::Quads);
+        vertices.resize(static_cast<size_t>(rows) * cols * 4);
+        queued.assign(static_cast<size_t>(rows) * cols, false);
+        dirty.clear();
+
+        for (int i = 0; i < rows; ++i) {
+            for (int j = 0; j < cols; ++j) {
+                sf::Vertex* quad = &vertices[(static_cast<size_t>(i) * cols + j) * 4];
+                float x = static_cast<float>(j * tile), y = static_cast<float>(i * tile);
+                quad[0].position = sf::Vector2f(x, y);
+                quad[1].position = sf::Vector2f(x + size, y);
+                quad[2].position = sf::Vector2f(x + size, y + size);
+                quad[3].position = sf::Vector2f(x, y + size);
+                setColor(quad, cellColor(grid.at(i, j)));
             }
         }
     }
-    // Re-set start and end points after random path additions
-    grid[start.x][start.y] = START;
-    grid[endpoint.x][endpoint.y] = END;
-}
 
-// Draws the grid on the SFML window
-void drawGrid(sf::RenderWindow& window) {
-    for (int i = 0; i < ROWS; ++i) {
-        for (int j = 0; j < COLS; ++j) {
-            sf::RectangleShape cell(sf::Vector2f(TILE_SIZE - 1, TILE_SIZE - 1)); // -1 for border effect
-            cell.setPosition(j * static_cast<float>(TILE_SIZE), i * static_cast<float>(TILE_SIZE));
-
-            // Set color based on cell type
-            switch (grid[i][j]) {
-            case WALL:      cell.setFillColor(sf::Color::White); break;
-            case PATH:      cell.setFillColor(sf::Color::Black); break;
-            case START:     cell.setFillColor(sf::Color(255, 0, 255)); break;
-            case END:       cell.setFillColor(sf::Color(158, 135, 204)); break;
-            case VISITED:   cell.setFillColor(sf::Color(242, 216, 253)); break;
-            case FINAL_PATH:cell.setFillColor(sf::Color(151, 29, 136)); break;
-            default:        cell.setFillColor(sf::Color::Magenta); break;
-            }
+    // Queues a cell to be recoloured from the grid at the next draw
+    void markDirty(Point p) {
+        size_t k = static_cast<size_t>(p.x) * cols + p.y;
+        if (queued[k]) return;
+        queued[k] = true;
+        dirty.push_back(static_cast<int>(k));
+    }
 
-            window.draw(cell);
+    void draw(sf::RenderWindow& window, const Grid& grid) {
+        for (int k : dirty) {
+            setColor(&vertices[static_cast<size_t>(k) * 4], cellColor(grid.at(k / cols, k % cols)));
+            queued[k] = false;
         }
+        dirty.clear();
+        window.draw(vertices);
     }
-}
 
-// Traces the path from endpoint back to start using parent pointers
-void tracePath(Point p, int& pathLength, sf::RenderWindow& window) {
-    pathLength = 0;
-    vector<Point> path;
-
-    // Backtrack from end to start and store in a vector
-    while (!(p == start)) {
-        if (grid[p.x][p.y] != START && grid[p.x][p.y] != END) {
-            path.push_back(p);
-            pathLength++;
-        }
-        p = parent[p.x][p.y];
+private:
+    static void setColor(sf::Vertex* quad, sf::Color color) {
+        for (int v = 0; v < 4; ++v) quad[v].color = color;
     }
 
-    // Reverse path so animation plays from start to end
-    reverse(path.begin(), path.end());
+    int rows = 0, cols = 0;
+    sf::VertexArray vertices;
+    vector<bool> queued; // Cell is already in dirty
+    vector<int> dirty;   // Row-major cell numbers changed since the last draw
+};
 
-    for (Point pt : path) {
-        grid[pt.x][pt.y] = FINAL_PATH;
-        window.clear();
-        drawGrid(window);
-        window.display();
-        delay(10);
-    }
-}
+// The maze being visualized and the query state used to solve it
+Grid grid;
+Point start(0, 0);
+Point endpoint(ROWS - 1, COLS - 1);
+SearchContext query(grid);
+GridRenderer renderer;
 
+// Cells painted VISITED or FINAL_PATH since the last reset
+vector<Point> painted;
 
-// Breadth-First Search (BFS) algorithm
-bool bfs(int& nodesExplored, sf::RenderWindow& window) {
-    memset(visited, false, sizeof(visited));
-    memset(parent, 0, sizeof(parent));
-    queue<Point> q;
-    q.push(start);
-    visited[start.x][start.y] = true;
-    nodesExplored = 0;
-    parent[start.x][start.y] = start;
+// Changes a cell and queues it for redrawing
+void setCell(Point p, char mark) {
+    grid.at(p.x, p.y) = mark;
+    renderer.markDirty(p);
+}
 
-    while (!q.empty()) {
-        Point curr = q.front(); q.pop();
-        nodesExplored++;
+// Marks a cell for display and remembers it so it can be cleared later
+void paintCell(Point p, char mark) {
+    char cell = grid.at(p.x, p.y);
+    if (cell == START || cell == END) return;
+    if (cell == PATH) painted.push_back(p);
+    setCell(p, mark);
+}
 
-        if (curr == endpoint) return true;
+// Resets the grid path visualization (turns painted cells back to PATH)
+void resetGridPath() {
+    for (Point p : painted)
+        setCell(p, PATH);
+    painted.clear();
+    setCell(start, START);
+    setCell(endpoint, END);
+}
 
-        for (int i = 0; i < DIRS_4; ++i) {
-            int nx = curr.x + dx_4[i];
-            int ny = curr.y + dy_4[i];
-            if (isValid(nx, ny) && !visited[nx][ny]) {
-                visited[nx][ny] = true;
-                parent[nx][ny] = curr;
-                q.push(Point(nx, ny));
+// Draws the grid on the SFML window
+void drawGrid(sf::RenderWindow& window) {
+    renderer.draw(window, grid);
+}
 
-                if (grid[nx][ny] != END) grid[nx][ny] = VISITED;
-                window.clear(); drawGrid(window); window.display();
-                delay(5);
-            }
+// The pre-batching renderer: one RectangleShape and one draw call per cell, every frame.
+// Only used by the frame-time comparison.
+void drawGridPerCell(sf::RenderWindow& window, int tile) {
+    float size = static_cast<float>(tile >= 4 ? tile - 1 : tile);
+    for (int i = 0; i < grid.rows(); ++i) {
+        for (int j = 0; j < grid.cols(); ++j) {
+            sf::RectangleShape cell(sf::Vector2f(size, size));
+            cell.setPosition(j * static_cast<float>(tile), i * static_cast<float>(tile));
+            cell.setFillColor(cellColor(grid.at(i, j)));
+            window.draw(cell);
         }
     }
-    return false;
 }
 
+// Replay speed in search events per frame; set with --speed, changed with Up/Down
+int replaySpeed = 4;
+const int FRAME_RATE = 60;
 
-// Depth-First Search (DFS) algorithm (recursive)
-bool dfs(Point curr, int& nodesExplored, sf::RenderWindow& window) {
-    if (!isValid(curr.x, curr.y) || visited[curr.x][curr.y]) return false;
-
-    visited[curr.x][curr.y] = true;
-    nodesExplored++;
-
-    if (curr == endpoint) return true;
+// Events of the last solver run, replayed onto the grid by replay()
+SearchLog searchLog(grid);
 
-    for (int i = 0; i < DIRS_4; ++i) {
-        int nx = curr.x + dx_4[i];
-        int ny = curr.y + dy_4[i];
-        Point next(nx, ny);
-
-        if (isValid(nx, ny) && !visited[nx][ny]) {
-            parent[nx][ny] = curr;
-
-            if (grid[nx][ny] != END) grid[nx][ny] = VISITED;
-            window.clear(); drawGrid(window); window.display();
-            delay(5);
-
-            if (dfs(next, nodesExplored, window)) return true;
-        }
+// Paints the grid as it looks right after event i
+void applyEvent(const SearchLog& log, size_t i) {
+    switch (log.type(i)) {
+    case SearchEvent::Relax:  paintCell(log.point(i), VISITED); break;
+    case SearchEvent::Expand: paintCell(log.point(i), EXPANDED); break;
+    case SearchEvent::Path:   paintCell(log.point(i), FINAL_PATH); break;
     }
-    return false;
 }
 
-// Dijkstra's algorithm
-bool dijkstra(int& nodesExplored, sf::RenderWindow& window) {
-    memset(visited, false, sizeof(visited));
-    memset(parent, 0, sizeof(parent));
-    for (int i = 0; i < ROWS; ++i)
-        for (int j = 0; j < COLS; ++j)
-            dist[i][j] = numeric_limits<int>::max();
-
-    dist[start.x][start.y] = 0;
-    typedef pair<int, Point> PIP;
-    priority_queue<PIP, vector<PIP>, greater<PIP>> pq;
-    pq.push({ 0, start });
-    nodesExplored = 0;
-    parent[start.x][start.y] = start;
-
-    while (!pq.empty()) {
-        PIP top = pq.top(); pq.pop();
-        Point curr = top.second;
-        if (visited[curr.x][curr.y]) continue;
-
-        visited[curr.x][curr.y] = true;
-        nodesExplored++;
-
-        if (curr == endpoint) return true;
-
-        for (int i = 0; i < DIRS_4; ++i) {
-            int nx = curr.x + dx_4[i];
-            int ny = curr.y + dy_4[i];
-            if (isValid(nx, ny) && dist[nx][ny] > dist[curr.x][curr.y] + 1) {
-                dist[nx][ny] = dist[curr.x][curr.y] + 1;
-                parent[nx][ny] = curr;
-                pq.push({ dist[nx][ny], Point(nx, ny) });
-
-                if (grid[nx][ny] != END) grid[nx][ny] = VISITED;
-                window.clear(); drawGrid(window); window.display();
-                delay(5);
-            }
-        }
+// Moves the replay to `target` events applied. Going backwards repaints from the start,
+// which is cheap next to drawing since only changed cells reach the renderer.
+void seekReplay(const SearchLog& log, size_t& cursor, size_t target) {
+    if (target < cursor) {
+        resetGridPath();
+        cursor = 0;
     }
-    return false;
-}
-
-// Manhattan distance heuristic for 4-directional movement (used by A*)
-int heuristic_manhattan(Point a, Point b) {
-    return abs(a.x - b.x) + abs(a.y - b.y);
+    for (; cursor < target; ++cursor) applyEvent(log, cursor);
 }
 
-// Chebyshev distance heuristic for 8-directional movement (used by JPS)
-int heuristic_chebyshev(Point a, Point b) {
-    return max(abs(a.x - b.x), abs(a.y - b.y));
-}
+// Replays a recorded search at replaySpeed events per frame in a regular event loop.
+// Space pauses, Left/Right step one frame's worth of events back/forward, Up/Down double
+// or halve the speed, Home/End jump to either end, Enter/Escape finish. With holdAtEnd
+// the replay stays scrubbable after the last event until the window is closed; otherwise
+// it returns once every event is shown. Returns false if the window was closed.
+bool replay(sf::RenderWindow& window, const SearchLog& log, const string& name, bool holdAtEnd) {
+    size_t cursor = 0;
+    bool paused = false;
+    string title;
 
-// A* search algorithm
-bool astar(int& nodesExplored, sf::RenderWindow& window) {
-    memset(visited, false, sizeof(visited));
-    memset(parent, 0, sizeof(parent));
-    for (int i = 0; i < ROWS; ++i)
-        for (int j = 0; j < COLS; ++j)
-            gScore[i][j] = numeric_limits<int>::max();
-
-    gScore[start.x][start.y] = 0;
-    typedef pair<int, Point> PIP;
-    priority_queue<PIP, vector<PIP>, greater<PIP>> openSet;
-    openSet.push({ heuristic_manhattan(start, endpoint), start });
-    nodesExplored = 0;
-    parent[start.x][start.y] = start;
-
-    while (!openSet.empty()) {
-        PIP top = openSet.top(); openSet.pop();
-        Point curr = top.second;
-        if (visited[curr.x][curr.y]) continue;
-
-        visited[curr.x][curr.y] = true;
-        nodesExplored++;
-
-        if (curr == endpoint) return true;
-
-        for (int i = 0; i < DIRS_4; ++i) {
-            int nx = curr.x + dx_4[i];
-            int ny = curr.y + dy_4[i];
-            if (!isValid(nx, ny)) continue;
-
-            int tentative_g = gScore[curr.x][curr.y] + 1;
-            if (tentative_g < gScore[nx][ny]) {
-                gScore[nx][ny] = tentative_g;
-                parent[nx][ny] = curr;
-                openSet.push({ tentative_g + heuristic_manhattan(Point(nx, ny), endpoint), Point(nx, ny) });
-
-                if (grid[nx][ny] != END) grid[nx][ny] = VISITED;
+    while (window.isOpen()) {
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+                return false;
+            }
+            if (event.type != sf::Event::KeyPressed) continue;
+
+            size_t step = static_cast<size_t>(replaySpeed);
+            switch (event.key.code) {
+            case sf::Keyboard::Space: paused = !paused; break;
+            case sf::Keyboard::Right: paused = true; seekReplay(log, cursor, min(log.size(), cursor + step)); break;
+            case sf::Keyboard::Left:  paused = true; seekReplay(log, cursor, cursor > step ? cursor - step : 0); break;
+            case sf::Keyboard::Up:    replaySpeed = min(replaySpeed * 2, 1 << 24); break;
+            case sf::Keyboard::Down:  replaySpeed = max(replaySpeed / 2, 1); break;
+            case sf::Keyboard::Home:  paused = true; seekReplay(log, cursor, 0); break;
+            case sf::Keyboard::End:   seekReplay(log, cursor, log.size()); break;
+            case sf::Keyboard::Enter:
+            case sf::Keyboard::Escape:
+                seekReplay(log, cursor, log.size());
+                if (holdAtEnd) break;
                 window.clear(); drawGrid(window); window.display();
-                delay(5);
+                return true;
+            default: break;
             }
         }
-    }
-    return false;
-}
-
-// Checks for forced neighbors in JPS
-bool hasForcedNeighbor(int x, int y, int dx, int dy) {
-    // Diagonal move
-    if (dx != 0 && dy != 0) {
-        // Check for obstacles that force a turn
-        if ((isValid(x - dx, y + dy) && !isValid(x - dx, y)) ||
-            (isValid(x + dx, y - dy) && !isValid(x, y - dy)))
-            return true;
-    }
-    // Cardinal horizontal move
-    else if (dx != 0) { // Moving horizontally (dx != 0, dy == 0)
-        // Check for obstacles that force a turn
-        if ((isValid(x + dx, y + 1) && !isValid(x, y + 1)) ||
-            (isValid(x + dx, y - 1) && !isValid(x, y - 1)))
-            return true;
-    }
-    // Cardinal vertical move
-    else if (dy != 0) { // Moving vertically (dx == 0, dy != 0)
-        // Check for obstacles that force a turn
-        if ((isValid(x + 1, y + dy) && !isValid(x + 1, y)) ||
-            (isValid(x - 1, y + dy) && !isValid(x - 1, y)))
-            return true;
-    }
-    return false;
-}
-
-// Jump function for JPS
-bool jump(int x, int y, int dx, int dy, Point& end, Point& out) {
-    // Base cases for recursion
-    if (!isValid(x, y) || grid[x][y] == WALL) return false; // Invalid or wall
-    if (Point(x, y) == end) { // Reached endpoint
-        out = Point(x, y);
-        return true;
-    }
-    if (hasForcedNeighbor(x, y, dx, dy)) { // Found a forced neighbor
-        out = Point(x, y);
-        return true;
-    }
 
-    // If moving diagonally, check cardinal directions for forced neighbors
-    if (dx != 0 && dy != 0) {
-        Point temp;
-        // Check if a jump point exists in cardinal directions
-        if (jump(x + dx, y, dx, 0, end, temp) || jump(x, y + dy, 0, dy, end, temp)) {
-            out = Point(x, y);
+        if (!paused) seekReplay(log, cursor, min(log.size(), cursor + static_cast<size_t>(replaySpeed)));
+        if (cursor == log.size() && !holdAtEnd) {
+            window.clear(); drawGrid(window); window.display();
             return true;
         }
-    }
-    // Continue jumping in the current direction
-    return jump(x + dx, y + dy, dx, dy, end, out);
-}
 
-// Jump Point Search (JPS) algorithm
-bool jps(int& nodesExplored, sf::RenderWindow& window) {
-    memset(visited, false, sizeof(visited));
-    memset(parent, 0, sizeof(parent));
-    for (int i = 0; i < ROWS; ++i)
-        for (int j = 0; j < COLS; ++j)
-            gScore[i][j] = numeric_limits<int>::max();
-
-    gScore[start.x][start.y] = 0;
-    typedef pair<int, Point> PIP;
-    priority_queue<PIP, vector<PIP>, greater<PIP>> openSet;
-    openSet.push({ heuristic_chebyshev(start, endpoint), start });
-    nodesExplored = 0;
-    parent[start.x][start.y] = start;
-
-    while (!openSet.empty()) {
-        PIP top = openSet.top(); openSet.pop();
-        Point curr = top.second;
-        if (visited[curr.x][curr.y]) continue;
-
-        visited[curr.x][curr.y] = true;
-        nodesExplored++;
-
-        if (curr == endpoint) return true;
-
-        for (int i = 0; i < DIRS_8; ++i) {
-            int dx_ = dx_8[i], dy_ = dy_8[i];
-            Point jumpPoint;
-            if (jump(curr.x + dx_, curr.y + dy_, dx_, dy_, endpoint, jumpPoint)) {
-                int tentative_g = gScore[curr.x][curr.y] + heuristic_chebyshev(curr, jumpPoint);
-                if (tentative_g < gScore[jumpPoint.x][jumpPoint.y]) {
-                    gScore[jumpPoint.x][jumpPoint.y] = tentative_g;
-                    parent[jumpPoint.x][jumpPoint.y] = curr;
-                    openSet.push({ tentative_g + heuristic_chebyshev(jumpPoint, endpoint), jumpPoint });
-
-                    if (grid[jumpPoint.x][jumpPoint.y] != END)
-                        grid[jumpPoint.x][jumpPoint.y] = VISITED;
-
-                    window.clear(); drawGrid(window); window.display();
-                    delay(5);
-                }
-            }
+        string status = name + ": " + to_string(cursor) + "/" + to_string(log.size()) + " events, " +
+            to_string(replaySpeed) + " per frame" + (paused ? " [paused]" : "");
+        if (status != title) {
+            window.setTitle(status);
+            title = status;
         }
+        window.clear();
+        drawGrid(window);
+        window.display();
     }
     return false;
 }
 
-// Resets the grid path visualization (turns VISITED cells back to PATH)
-void resetGridPath() {
-    for (int i = 0; i < ROWS; ++i)
-        for (int j = 0; j < COLS; ++j)
-            if (grid[i][j] == VISITED || grid[i][j] == FINAL_PATH)
-                grid[i][j] = PATH;
-    grid[start.x][start.y] = START;
-    grid[endpoint.x][endpoint.y] = END;
+// Times a headless run of the solver, then runs it again with searchLog attached to
+// record it for replay. Only the headless run is measured, so recording doesn't leak
+// into the timing.
+bool timedSolve(int choice, int& nodesExplored, long long& micros) {
+    Solver solve = SOLVERS[choice - 1].solve;
+    query.start = start;
+    query.goal = endpoint;
+
+    auto start_time = chrono::steady_clock::now();
+    bool found = solve(query, nullptr);
+    auto end_time = chrono::steady_clock::now();
+    micros = chrono::duration_cast<chrono::microseconds>(end_time - start_time).count();
+    nodesExplored = query.stats.nodesExplored;
+
+    recordSearch(query, solve, searchLog);
+    return found;
 }
 
-// Runs a selected pathfinding algorithm and displays results
+// Runs a selected pathfinding algorithm, prints its results and replays it
 void runAlgorithm(int choice, sf::RenderWindow& window) {
     resetGridPath();
-    memset(parent, 0, sizeof(parent));
-    bool found = false;
-    int pathLength = 0;
     int nodesExplored = 0;
-    string name;
-    auto start_time = chrono::high_resolution_clock::now();
-
-    if (choice == 1) {
-        name = "BFS";
-        found = bfs(nodesExplored, window);
-    }
-    else if (choice == 2) {
-        name = "DFS";
-        parent[start.x][start.y] = start;
-        found = dfs(start, nodesExplored, window);
-    }
-    else if (choice == 3) {
-        name = "Dijkstra";
-        found = dijkstra(nodesExplored, window);
-    }
-    else if (choice == 4) {
-        name = "A*";
-        found = astar(nodesExplored, window);
-    }
-    else if (choice == 5) {
-        name = "JumpPoint";
-        found = jps(nodesExplored, window);
-    }
-
-    auto end_time = chrono::high_resolution_clock::now();
-    auto duration = chrono::duration_cast<chrono::microseconds>(end_time - start_time);
+    long long micros = 0;
+    string name = SOLVERS[choice - 1].name;
+    bool found = timedSolve(choice, nodesExplored, micros);
 
     if (found) {
-        tracePath(endpoint, pathLength, window);
-        grid[start.x][start.y] = START;
-        grid[endpoint.x][endpoint.y] = END;
-        window.clear(); drawGrid(window); window.display();
-
         cout << "\nAlgorithm: " << name
-            << "\nPath Length: " << pathLength
+            << "\nPath Length: " << searchLog.pathLength()
             << "\nNodes Explored: " << nodesExplored
-            << "\nTime Taken: " << duration.count() << " microseconds."
-            << "\nOperations: " << (pathLength * nodesExplored) << endl;
+            << "\nTime Taken: " << micros << " microseconds."
+            << "\nPushes / Pops: " << query.stats.pushes << " / " << query.stats.pops << endl;
+        if (query.stats.expandedBackward)
+            cout << "Expanded from start / goal: " << query.stats.expandedForward << " / " << query.stats.expandedBackward << endl;
+        if (PROFILE_ENABLED)
+            cout << "Stale pops: " << query.profile.stalePops << ", isValid calls: " << query.profile.isValidCalls
+                << ", jumps / steps: " << query.profile.jumpCalls << " / " << query.profile.jumpSteps
+                << "\nReset: " << profileMicroseconds(query.profile.resetTicks) << " us, path reconstruction: "
+                << profileMicroseconds(query.profile.reconstructTicks) << " us" << endl;
     }
     else {
         cout << "\nPath not found by " << name << ".\n";
     }
+    replay(window, searchLog, name, true);
 }
+
 // Compares all algorithms and prints their statistics
 void compareAlgorithms(sf::RenderWindow& window) {
-    string names[] = { "BFS", "DFS", "Dijkstra", "A*", "JumpPoint" };
-    cout << left << setw(12) << "Algorithm" << setw(15) << "Path Length" << setw(18) << "Nodes Explored" << setw(18) << "Time (us)" << "Operations" << endl;
+    cout << "Single run on this maze; use `Benchmark batch` for latency percentiles over many mazes." << endl;
+    cout << left << setw(12) << "Algorithm" << setw(15) << "Path Length" << setw(18) << "Nodes Explored" << setw(18) << "Time (us)" << "Pushes / Pops" << endl;
+    cout << "(bidirectional: nodes expanded from start+goal)" << endl;
     cout << string(80, '-') << endl;
 
-    for (int i = 1; i <= 5; ++i) {
+    for (int i = 1; i <= NUM_SOLVERS; ++i) {
         resetGridPath();
-        memset(parent, 0, sizeof(parent));
-
-        bool found = false;
-        int pathLength = 0, nodesExplored = 0;
-        auto start_time = chrono::high_resolution_clock::now();
-
-        if (i == 1) found = bfs(nodesExplored, window);
-        else if (i == 2) {
-            parent[start.x][start.y] = start;
-            found = dfs(start, nodesExplored, window);
-        }
-        else if (i == 3) found = dijkstra(nodesExplored, window);
-        else if (i == 4) found = astar(nodesExplored, window);
-        else if (i == 5) found = jps(nodesExplored, window);
 
-        auto end_time = chrono::high_resolution_clock::now();
-        auto duration = chrono::duration_cast<chrono::microseconds>(end_time - start_time);
+        int nodesExplored = 0;
+        long long micros = 0;
+        bool found = timedSolve(i, nodesExplored, micros);
 
-        if (found) tracePath(endpoint, pathLength, window);
-        else pathLength = 0;
+        cout << left << setw(12) << SOLVERS[i - 1].name
+            << setw(15) << (found ? to_string(searchLog.pathLength()) : "N/A")
+            << setw(18) << (query.stats.expandedBackward ? to_string(nodesExplored) + " (" +
+                to_string(query.stats.expandedForward) + "+" + to_string(query.stats.expandedBackward) + ")" : to_string(nodesExplored))
+            << setw(18) << micros
+            << query.stats.pushes << " / " << query.stats.pops << endl;
 
-        cout << left << setw(12) << names[i - 1]
-            << setw(15) << (found ? to_string(pathLength) : "N/A")
-            << setw(18) << nodesExplored
-            << setw(18) << duration.count()
-            << (found ? to_string(pathLength * nodesExplored) : "N/A") << endl;
+        if (!replay(window, searchLog, SOLVERS[i - 1].name, i == NUM_SOLVERS)) break;
     }
     cout << endl;
 }
@@ -545,23 +322,23 @@ void runMenu(sf::RenderWindow& window, int& selectedAlgo) {
         return;
     }
 
-    vector<string> options = {
-        "Run BFS",
-        "Run DFS",
-        "Run Dijkstra",
-        "Run A*",
-        "Run Jump Point",
-        "Compare Algorithms"
-    };
+    vector<string> options;
+    for (int i = 0; i < NUM_SOLVERS; ++i) options.push_back(string("Run ") + SOLVERS[i].name);
+    options.push_back("Compare Algorithms");
+
+    // Spread the entries over the window height, shrinking them if there are many
+    float top = 100.f;
+    float spacing = min(60.f, (window.getSize().y - top) / options.size());
+    unsigned fontSize = static_cast<unsigned>(min(36.f, spacing * 0.6f));
 
     vector<sf::Text> menuTexts;
     for (int i = 0; i < options.size(); i++) {
-        sf::Text text(options[i], font, 36);
+        sf::Text text(options[i], font, fontSize);
         text.setFillColor(sf::Color::Black);
         // Center the text
         sf::FloatRect textRect = text.getLocalBounds();
         text.setOrigin(textRect.left + textRect.width / 2.0f, textRect.top + textRect.height / 2.0f);
-        text.setPosition(window.getSize().x / 2.0f, 150.f + i * 60.f); // Position vertically
+        text.setPosition(window.getSize().x / 2.0f, top + (i + 0.5f) * spacing); // Position vertically
         menuTexts.push_back(text);
     }
 
@@ -612,18 +389,98 @@ void runMenu(sf::RenderWindow& window, int& selectedAlgo) {
 }
 
 
-int main() {
-    // Seed random number generator for maze generation
-    srand(static_cast<unsigned int>(time(0)));
+// Prints the average frame time of the per-cell renderer and of GridRenderer on the
+// current grid. Every frame first repaints a batch of random cells, like a search step.
+void reportFrameTimes(sf::RenderWindow& window, int tile, int frames) {
+    const int CHANGES_PER_FRAME = 1000;
+    vector<Point> open;
+    for (int i = 0; i < grid.rows(); ++i)
+        for (int j = 0; j < grid.cols(); ++j)
+            if (grid.at(i, j) == PATH) open.push_back(Point(i, j));
+    mt19937 rng(1);
+    uniform_int_distribution<size_t> pick(0, open.size() - 1);
+
+    auto averageMs = [&](bool batched) {
+        auto start_time = chrono::steady_clock::now();
+        for (int f = 0; f < frames; ++f) {
+            for (int c = 0; c < CHANGES_PER_FRAME; ++c) paintCell(open[pick(rng)], VISITED);
+            window.clear();
+            if (batched) drawGrid(window);
+            else drawGridPerCell(window, tile);
+            window.display();
+        }
+        resetGridPath();
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count() / frames;
+    };
 
-    // Generate the maze before anything else
-    guaranteeSolvableMaze();
+    double perCell = averageMs(false);
+    double batched = averageMs(true);
+    cout << "Frame time on " << grid.rows() << "x" << grid.cols() << " (" << tile << " px cells, "
+        << CHANGES_PER_FRAME << " cell changes per frame, " << frames << " frames):" << endl;
+    cout << fixed << setprecision(2)
+        << "  per-cell RectangleShape: " << perCell << " ms" << endl
+        << "  vertex array:            " << batched << " ms (" << perCell / batched << "x faster)" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    // Replay speed (search events per frame) from --speed N anywhere on the command line
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (string(argv[i]) == "--speed") {
+            replaySpeed = max(1, atoi(argv[i + 1]));
+            for (int j = i; j + 2 <= argc; ++j) argv[j] = argv[j + 2];
+            argc -= 2;
+            break;
+        }
+    }
 
-    // Create the SFML window sized according to grid dimensions
-    sf::RenderWindow window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), "HK's Maze Visualizer");
+    // Frame-time comparison instead of the interactive visualizer: Pathfinder frametime [rows cols frames]
+    bool frameTimeMode = argc >= 2 && string(argv[1]) == "frametime";
+    if (frameTimeMode) {
+        --argc;
+        ++argv;
+    }
+
+    // Generate the maze before anything else
+    // Optional map from the command line: Pathfinder [rows cols [seed [algorithm [knockout%]]]]
+    // A fresh seed is picked from the clock unless one is given, and printed so the maze can be reproduced.
+    MazeOptions maze;
+    maze.seed = static_cast<uint64_t>(time(0));
+    if (frameTimeMode) maze.rows = maze.cols = 1000;
+    if (argc >= 3) {
+        maze.rows = max(2, atoi(argv[1]));
+        maze.cols = max(2, atoi(argv[2]));
+    }
+    if (argc >= 4 && !frameTimeMode) maze.seed = strtoull(argv[3], nullptr, 10);
+    if (argc >= 5 && !frameTimeMode && !parseMazeAlgorithm(argv[4], maze.algorithm)) {
+        cout << "Unknown maze algorithm '" << argv[4] << "' (backtracker, prim, kruskal or open)" << endl;
+        return 1;
+    }
+    if (argc >= 6 && !frameTimeMode) maze.knockoutPercent = atoi(argv[5]);
+    generateMaze(grid, maze);
+    cout << "Maze " << maze.rows << "x" << maze.cols << ", seed " << maze.seed << ", "
+        << mazeAlgorithmName(maze.algorithm) << ", " << maze.knockoutPercent << "% knockout" << endl;
+    int rows = maze.rows, cols = maze.cols;
+    endpoint = Point(rows - 1, cols - 1);
+
+    // Create the SFML window sized according to grid dimensions; the view maps the whole
+    // grid onto it, scaling down grids too big for the window
+    int tile = tileSizeFor(rows, cols);
+    sf::Vector2u windowSize = windowSizeFor(rows, cols, tile);
+    sf::RenderWindow window(sf::VideoMode(windowSize.x, windowSize.y), "HK's Maze Visualizer");
+    sf::View gridView(sf::FloatRect(0.f, 0.f, static_cast<float>(cols * tile), static_cast<float>(rows * tile)));
+    window.setView(gridView);
+    renderer.build(grid, tile);
+
+    if (frameTimeMode) {
+        reportFrameTimes(window, tile, argc >= 4 ? max(1, atoi(argv[3])) : 10);
+        return 0;
+    }
+    window.setFramerateLimit(FRAME_RATE);
 
     int selectedAlgo = 0;
+    window.setView(window.getDefaultView()); // The menu is laid out in window pixels
     runMenu(window, selectedAlgo); // Show the menu and get algorithm choice
+    window.setView(gridView);
 
     // Clear screen before algorithm runs to show a fresh grid
     window.clear(sf::Color::White);
@@ -632,10 +489,10 @@ int main() {
     sf::sleep(sf::seconds(1)); // Optional pause to see initial maze
 
     // Run selected algorithm or comparison based on menu choice
-    if (selectedAlgo >= 1 && selectedAlgo <= 5) {
+    if (selectedAlgo >= 1 && selectedAlgo <= NUM_SOLVERS) {
         runAlgorithm(selectedAlgo, window); // Run a single algorithm
     }
-    else if (selectedAlgo == 6) {
+    else if (selectedAlgo == NUM_SOLVERS + 1) {
         compareAlgorithms(window); // Run comparison of all algorithms
     }
 